@@ -0,0 +1,70 @@
+#!/usr/bin/env bash
+set -e
+
+# measure the wall time from exec to exit of common invocations
+# uses hyperfine when available, otherwise falls back to a timed loop
+
+if [[ $# > 2 ]]; then
+  printf "usage: ./bench.sh [path/to/stig] [runs]\n";
+  exit 1
+fi
+
+# source environment variables
+source ./env.sh
+
+BIN="${1:-./build/release/${APP}}"
+RUNS="${2:-200}"
+QUERY="stig"
+
+if [[ ! -x ${BIN} ]]; then
+  printf "error: '${BIN}' not found, build it first with ./build.sh\n"
+  exit 1
+fi
+
+bench() {
+  local name="$1"
+  shift
+
+  if command -v hyperfine > /dev/null; then
+    hyperfine -N --warmup 10 --runs "${RUNS}" --command-name "${name}" "$*"
+    return
+  fi
+
+  # warm the page cache
+  for ((i = 0; i < 10; ++i)); do
+    "$@" > /dev/null 2>&1 || true
+  done
+
+  local begin
+  local end
+
+  for ((i = 0; i < RUNS; ++i)); do
+    begin=${EPOCHREALTIME/./}
+    "$@" > /dev/null 2>&1 || true
+    end=${EPOCHREALTIME/./}
+    printf "%d\n" $((end - begin))
+  done | sort -n | awk -v name="${name}" '
+    { t[NR] = $1 / 1000; sum += t[NR] }
+    END {
+      printf "%-8s mean %7.3f ms  median %7.3f ms  min %7.3f ms  max %7.3f ms  (%d runs)\n",
+        name, sum / NR, t[int((NR + 1) / 2)], t[1], t[NR], NR
+    }'
+}
+
+printf "\nBenchmarking ${BIN}\n\n"
+
+bench "version" "${BIN}" --version
+bench "help" "${BIN}" --help
+
+# make a single request to populate the cache, then time cache hits
+CACHED=("${BIN}" --query "${QUERY}" --cache 31536000 --color off)
+"${CACHED[@]}" > /dev/null 2>&1 || true
+
+# a cache hit renders without entering the network phase
+STATS="$("${CACHED[@]}" --stats 2>&1 > /dev/null || true)"
+
+if grep -q "^render" <<< "${STATS}" && ! grep -q "^network" <<< "${STATS}"; then
+  bench "cached" "${CACHED[@]}"
+else
+  printf "%-8s skipped, could not populate the cache\n" "cached"
+fi
@@ -4,24 +4,60 @@ using Parg = OB::Parg;
 #include "ob/string.hh"
 namespace String = OB::String;
 
+#include "ob/term.hh"
+namespace Term = OB::Term;
+
 #include "stig/stig.hh"
+#include "stig/stats.hh"
+#include "stig/complete.hh"
+#include "stig/tui.hh"
 namespace Stig = OB::Stig;
 
 #include <string>
+#include <string_view>
 #include <iostream>
 
 int program_options(Parg& pg);
 
+// flags and options
+// the name lookup tables are generated at compile time
+constexpr auto options = Parg::table(
+  // general flags
+  Parg::flag("help,h", "print the help output"),
+  Parg::flag("version,v", "print the program version"),
+  Parg::flag("stats", "print allocation, memory, and timing statistics for each phase to stderr"),
+
+  // general options
+  Parg::option("token", "", "str", "used to validate against GitHub, enables a greater number of requests before being rate-limited"),
+  Parg::option("host", "api.github.com", "str", "perform GitHub API v3 requests against a custom host"),
+  Parg::option("api", "v3", "v3|graphql", "the GitHub API to search with, 'graphql' fetches each page with one query and requires '--token', default is v3"),
+  Parg::option("cache", "0", "int", "reuse a cached response up to 'int' seconds old instead of making a request, default is 0 which always makes a request"),
+
+  // query options
+  Parg::option("query,q", "", "str", "the query string"),
+  Parg::option("page,p", "1", "int", "the page number to get"),
+  Parg::option("number,n", "10", "int", "the number of results to show per page"),
+  Parg::option("sort,s", "best", "stars|forks|updated|best", "how to sort the search results, default is best match"),
+  Parg::option("order,o", "desc", "asc|desc", "the order to sort the search results, default is desc"),
+  Parg::option("filter,f", "", "key:value[ key:value]...", "filter results with space seperated key:value pairs"),
+  Parg::option("color,c", "auto", "on|off|auto", "used to determine the output color preference, default is auto"),
+  Parg::option("format", "text", "text|ndjson|json|tsv|csv", "the output format of the search results, default is text"),
+  Parg::option("template", "", "str", "print each search result as 'str', where '{field}' is replaced by a field and '{%color}' sets the color"),
+  Parg::flag("local", "search the repos saved from previous queries instead of making a request"),
+  Parg::option("watch", "", "int", "poll the query every 'int' seconds, printing only the repos added, removed, or changed since the last poll"),
+  Parg::flag("interactive,i", "browse the results in the terminal, 'j'/'k' to move, 'enter' to read the README, 'q' to quit"),
+  Parg::option("prefetch", "0", "int", "with '--api graphql', fetch the READMEs of the first 'int' results of each page in the same request and save them to the cache"),
+
+  // readme options
+  Parg::option("readme,r", "", "user/repo[/ref]", "print a repos README.md to stdout"),
+
+  // completion options
+  Parg::option("complete", "", "str", "print search qualifiers, 'language:' values, and previously seen 'user/repo' names that start with 'str', one per line")
+);
+
 int program_options(Parg& pg)
 {
-  pg.name("stig").version("0.1.6 (05.01.2019)");
-  pg.description("A CLI tool for searching Git repositories on GitHub.");
-  pg.usage("[flags] [options] [--] [arguments]");
-  pg.usage("[-q|--query str] [-p|--page int] [-n|--number int] [-s|--sort stars|forks|updated|best] [-o|--order asc|desc] [-f|--filter key:value[ key:value]...] [--token str] [--host str] [-c|--color on|off|auto]");
-  pg.usage("[-r|--readme user/repo[/ref]]");
-  pg.usage("[-v|--version]");
-  pg.usage("[-h|--help]");
-  pg.info("Examples", {
+  static constexpr std::string_view examples[] {
     "stig --query 'stig' --number 20 --page 1",
     "stig --query 'stig' --filter 'language:cpp'",
     "stig --query 'stig' | less",
@@ -30,37 +66,44 @@ int program_options(Parg& pg)
     "stig --readme 'octobanana/stig'",
     "stig --readme 'octobanana/stig/master'",
     "stig --readme 'octobanana/stig' | less",
+    "stig --readme 'octobanana/stig' --color on | less -R",
+    "stig --query 'stig' --format ndjson",
+    "stig --query 'stig' --template '{owner}/{repo}\\t{stars}\\t{language}'",
+    "stig --query 'stig' --cache 600",
+    "stig --query 'http server' --filter 'language:cpp stars:>10' --local",
+    "stig --query 'stig' --interactive",
+    "stig --query 'stig' --api graphql --token 'str' --prefetch 10 --interactive",
+    "stig --query 'http server' --filter 'language:cpp' --sort 'updated' --watch 300",
+    "stig --query 'stig' --stats",
+    "stig --complete 'octo'",
+    "stig --complete 'language:c'",
     "stig --help",
     "stig --version",
-  });
-  pg.info("Exit Codes", {"0 -> normal", "1 -> error"});
-  pg.info("Repository", {
+  };
+  static constexpr std::string_view exit_codes[] {"0 -> normal", "1 -> error"};
+  static constexpr std::string_view repository[] {
     "https://github.com/octobanana/stig.git",
-  });
-  pg.info("Homepage", {
+  };
+  static constexpr std::string_view homepage[] {
     "https://octobanana.com/software/stig",
-  });
-  pg.author("Brett Robinson (octobanana) <octobanana.dev@gmail.com>");
-
-  // general flags
-  pg.set("help,h", "print the help output");
-  pg.set("version,v", "print the program version");
-
-  // general options
-  pg.set("token", "", "str", "used to validate against GitHub, enables a greater number of requests before being rate-limited");
-  pg.set("host", "api.github.com", "str", "perform GitHub API v3 requests against a custom host");
+  };
 
-  // query options
-  pg.set("query,q", "", "str", "the query string");
-  pg.set("page,p", "1", "int", "the page number to get");
-  pg.set("number,n", "10", "int", "the number of results to show per page");
-  pg.set("sort,s", "best", "stars|forks|updated|best", "how to sort the search results, default is best match");
-  pg.set("order,o", "desc", "asc|desc", "the order to sort the search results, default is desc");
-  pg.set("filter,f", "", "key:value[ key:value]...", "filter results with space seperated key:value pairs");
-  pg.set("color,c", "auto", "on|off|auto", "used to determine the output color preference, default is auto");
+  pg.name("stig").version("0.1.6 (05.01.2019)");
+  pg.description("A CLI tool for searching Git repositories on GitHub.");
+  pg.usage("[flags] [options] [--] [arguments]");
+  pg.usage("[-q|--query str] [-p|--page int] [-n|--number int] [-s|--sort stars|forks|updated|best] [-o|--order asc|desc] [-f|--filter key:value[ key:value]...] [--token str] [--host str] [--api v3|graphql] [--prefetch int] [--cache int] [--local] [--watch int] [-i|--interactive] [-c|--color on|off|auto] [--format text|ndjson|json|tsv|csv] [--template str]");
+  pg.usage("[-r|--readme user/repo[/ref]] [--cache int] [-c|--color on|off|auto]");
+  pg.usage("[--complete str]");
+  pg.usage("[--stats]");
+  pg.usage("[-v|--version]");
+  pg.usage("[-h|--help]");
+  pg.info("Examples", examples);
+  pg.info("Exit Codes", exit_codes);
+  pg.info("Repository", repository);
+  pg.info("Homepage", homepage);
+  pg.author("Brett Robinson (octobanana) <octobanana.dev@gmail.com>");
 
-  // readme options
-  pg.set("readme,r", "", "user/repo[/ref]", "print a repos README.md to stdout");
+  pg.set(options);
 
   // pg.set_pos();
   // pg.set_stdin();
@@ -111,18 +154,74 @@ int program_options(Parg& pg)
     return 1;
   }
 
-  if (! pg.find("query") && ! pg.find("readme"))
+  if (! pg.find("query") && ! pg.find("readme") && ! pg.find("complete"))
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "expected either '--query', '--readme', or '--complete'" << "\n";
+
+    return -1;
+  }
+
+  if (pg.find("query") + pg.find("readme") + pg.find("complete") > 1)
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "choose either '--query', '--readme', or '--complete'" << "\n";
+
+    return -1;
+  }
+
+  if (pg.get<bool>("local") && ! pg.find("query"))
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "flag '--local' must be paired with '--query'" << "\n";
+
+    return -1;
+  }
+
+  if (pg.get<bool>("interactive") && ! pg.find("query"))
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "flag '--interactive' must be paired with '--query'" << "\n";
+
+    return -1;
+  }
+
+  if (pg.get<bool>("interactive") && (pg.find("format") || pg.find("template") || pg.find("page")))
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "flag '--interactive' can not be used with '--format', '--template', or '--page'" << "\n";
+
+    return -1;
+  }
+
+  if (pg.get<bool>("interactive") && ! (Term::is_term(STDIN_FILENO) && Term::is_term(STDOUT_FILENO)))
   {
     std::cerr << pg.help() << "\n";
-    std::cerr << "Error: " << "expected either '--query' or '--readme'" << "\n";
+    std::cerr << "Error: " << "flag '--interactive' requires stdin and stdout to be a terminal" << "\n";
 
     return -1;
   }
 
-  if (pg.find("query") && pg.find("readme"))
+  if (pg.find("watch") && ! pg.find("query"))
   {
     std::cerr << pg.help() << "\n";
-    std::cerr << "Error: " << "choose either '--query' or '--readme'" << "\n";
+    std::cerr << "Error: " << "option '--watch' must be paired with '--query'" << "\n";
+
+    return -1;
+  }
+
+  if (pg.find("watch") && (pg.get<bool>("local") || pg.get<bool>("interactive") || pg.find("format") || pg.find("template")))
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "option '--watch' can not be used with '--local', '--interactive', '--format', or '--template'" << "\n";
+
+    return -1;
+  }
+
+  if (pg.find("watch") && pg.get<std::size_t>("watch") < 1)
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "option '--watch' must be greater than zero" << "\n";
 
     return -1;
   }
@@ -151,7 +250,7 @@ int program_options(Parg& pg)
     return -1;
   }
 
-  if (pg.find("sort") && ! String::assert_rx(pg.get("sort"), std::regex("^stars|forks|updated|best$")))
+  if (pg.find("sort") && ! String::one_of(pg.get("sort"), {"stars", "forks", "updated", "best"}))
   {
     std::cerr << pg.help() << "\n";
     std::cerr << "Error: " << "option '--sort' contains an invalid value, try 'stars', 'forks', or 'updated'" << "\n";
@@ -159,7 +258,7 @@ int program_options(Parg& pg)
     return -1;
   }
 
-  if (pg.find("order") && ! String::assert_rx(pg.get("order"), std::regex("^asc|desc$")))
+  if (pg.find("order") && ! String::one_of(pg.get("order"), {"asc", "desc"}))
   {
     std::cerr << pg.help() << "\n";
     std::cerr << "Error: " << "option '--order' contains an invalid value, try 'asc' or 'desc'" << "\n";
@@ -167,7 +266,7 @@ int program_options(Parg& pg)
     return -1;
   }
 
-  if (pg.find("color") && ! String::assert_rx(pg.get("color"), std::regex("^on|off|auto$")))
+  if (pg.find("color") && ! String::one_of(pg.get("color"), {"on", "off", "auto"}))
   {
     std::cerr << pg.help() << "\n";
     std::cerr << "Error: " << "option '--color' contains an invalid value, try 'on', 'off', or 'auto'" << "\n";
@@ -175,20 +274,114 @@ int program_options(Parg& pg)
     return -1;
   }
 
+  if (pg.find("format") && ! String::one_of(pg.get("format"), {"text", "ndjson", "json", "tsv", "csv"}))
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "option '--format' contains an invalid value, try 'text', 'ndjson', 'json', 'tsv', or 'csv'" << "\n";
+
+    return -1;
+  }
+
+  if (pg.find("template") && pg.find("format") && pg.get("format") != "text")
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "option '--template' can only be used with the 'text' format" << "\n";
+
+    return -1;
+  }
+
+  if (pg.find("api") && ! String::one_of(pg.get("api"), {"v3", "graphql"}))
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "option '--api' contains an invalid value, try 'v3' or 'graphql'" << "\n";
+
+    return -1;
+  }
+
+  if (pg.get("api") == "graphql" && pg.get("token").empty())
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "option '--api graphql' requires '--token'" << "\n";
+
+    return -1;
+  }
+
+  if (pg.get("api") == "graphql" && (pg.find("watch") || pg.get<bool>("local")))
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "option '--api graphql' can not be used with '--watch' or '--local'" << "\n";
+
+    return -1;
+  }
+
+  if (pg.find("prefetch") && pg.get("api") != "graphql")
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "option '--prefetch' must be paired with '--api graphql'" << "\n";
+
+    return -1;
+  }
+
+  if (pg.find("prefetch") && pg.get<std::size_t>("prefetch") > 100)
+  {
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << "option '--prefetch' must be between 0 and 100" << "\n";
+
+    return -1;
+  }
+
   return 0;
 }
 
 int main(int argc, char *argv[])
 {
+  // counting starts before the args are parsed so that parsing is measured too
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::string_view(argv[i]) == "--stats")
+    {
+      Stig::Stats::enable();
+      break;
+    }
+
+    if (std::string_view(argv[i]) == "--")
+    {
+      break;
+    }
+  }
+
+  Stig::Stats::phase("args");
+
   Parg pg {argc, argv};
-  int pstatus {program_options(pg)};
+  int pstatus {0};
+
+  try
+  {
+    pstatus = program_options(pg);
+  }
+  catch(std::exception const& e)
+  {
+    // an option value that does not convert
+    std::cerr << pg.help() << "\n";
+    std::cerr << "Error: " << e.what() << "\n";
+
+    return 1;
+  }
+
   if (pstatus > 0) return 0;
   if (pstatus < 0) return 1;
 
   try
   {
+    // complete
+    if (pg.find("complete"))
+    {
+      Stig::Stats::phase("render");
+      Stig::Complete::print(pg.get("complete"), std::cout);
+    }
+
     // query
-    if (pg.find("query"))
+    else if (pg.find("query"))
     {
       auto query = pg.get("query");
       auto const filter = pg.get("filter");
@@ -235,8 +428,50 @@ int main(int argc, char *argv[])
       auto const per_page = pg.get<std::size_t>("number");
       auto const token = pg.get("token");
       auto const color = pg.get("color");
+      auto const format = pg.get("format");
+      auto const max_age = pg.get<std::size_t>("cache");
+      auto const api = pg.get("api");
+      auto const prefetch = pg.get<std::size_t>("prefetch");
+
+      // compile the template before making a request so errors are reported first
+      Stig::Template::Program tmpl;
 
-      Stig::search(host, query, sort, order, page, per_page, token, color);
+      if (pg.find("template"))
+      {
+        tmpl = Stig::Template::compile(pg.get("template"));
+      }
+
+      if (pg.find("watch"))
+      {
+        Stig::watch(host, query, sort, order, page, per_page, token, color, pg.get<std::size_t>("watch"));
+      }
+      else if (pg.get<bool>("interactive"))
+      {
+        Stig::Tui::Options opts;
+        opts.host = host;
+        opts.query = query;
+        opts.sort = sort;
+        opts.order = order;
+        opts.token = token;
+        opts.per_page = per_page;
+        opts.max_age = max_age;
+        opts.api = api;
+        opts.prefetch = prefetch;
+        opts.local = pg.get<bool>("local");
+        opts.is_color = color != "off";
+
+        Stig::Stats::phase("render");
+        Stig::Tui::run(opts);
+      }
+      else if (pg.get<bool>("local"))
+      {
+        Stig::search_local(query, sort, order, page, per_page, color, format, tmpl);
+      }
+      else
+      {
+        Stig::search(host, query, sort, order, page, per_page, token, color, format, tmpl, max_age,
+          api, prefetch);
+      }
     }
 
     // readme
@@ -244,18 +479,8 @@ int main(int argc, char *argv[])
     {
       auto const path = pg.get("readme");
 
-      struct match
-      {
-        enum
-        {
-          path,
-          repo,
-          ref
-        };
-      };
-
-      auto const valid_repo = String::match(path,
-        std::regex("^([^\\/]+?\\/[^\\/]+)(?:/([^\\/]+?))?$"));
+      // match 'user/repo' with an optional '/ref'
+      auto const valid_repo = String::fields<3>(path, '/', 2);
 
       if (! valid_repo)
       {
@@ -265,11 +490,15 @@ int main(int argc, char *argv[])
         );
       }
 
+      auto const& [user, name, tag] = valid_repo.value();
       auto const host = pg.get("host");
-      auto const repo = valid_repo.value().at(match::repo);
-      auto const ref = valid_repo.value().at(match::ref);
+      auto const repo = std::string(user) + "/" + std::string(name);
+      auto const ref = std::string(tag);
+      auto const max_age = pg.get<std::size_t>("cache");
 
-      Stig::readme(host, repo, ref);
+      auto const color = pg.get("color");
+
+      Stig::readme(host, repo, ref, color, max_age);
     }
   }
   catch(std::exception const& e)
@@ -281,5 +510,10 @@ int main(int argc, char *argv[])
     std::cerr << "Error: an unexpected error occurred\n";
   }
 
+  if (pg.get<bool>("stats"))
+  {
+    Stig::Stats::report(std::cerr);
+  }
+
   return 0;
 }
@@ -98,6 +98,10 @@ SOFTWARE.
 
 #include <boost/config.hpp>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include <cctype>
 #include <cstdlib>
 #include <cstddef>
@@ -105,6 +109,7 @@ SOFTWARE.
 #include <csignal>
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <iomanip>
 #include <vector>
@@ -117,6 +122,7 @@ SOFTWARE.
 #include <functional>
 #include <regex>
 #include <memory>
+#include <new>
 #include <chrono>
 #include <utility>
 #include <initializer_list>
@@ -326,6 +332,163 @@ private:
   std::deque<m_iterator> _it;
 }; // class Ordered_Map
 
+// Callback: a move only function wrapper
+// targets of up to 'N' bytes that move without throwing are stored in place,
+// so wrapping a lambda with a few captures does not allocate, larger targets go on the heap
+template<typename Sig, std::size_t N = 6 * sizeof(void*)>
+class Callback;
+
+template<typename R, typename... Args, std::size_t N>
+class Callback<R(Args...), N>
+{
+  template<typename T>
+  static constexpr bool is_local {sizeof(T) <= N &&
+    alignof(T) <= alignof(std::max_align_t) &&
+    std::is_nothrow_move_constructible_v<T>};
+
+  struct Ops
+  {
+    R (*call)(void*, Args&&...);
+
+    // move the target from the second buffer into the first and destroy the moved from target
+    void (*move)(void*, void*) noexcept;
+
+    void (*destroy)(void*) noexcept;
+  }; // struct Ops
+
+  template<typename T>
+  static constexpr Ops local_ops {
+    [](void* buf_, Args&&... args_) -> R
+    {
+      return (*static_cast<T*>(buf_))(std::forward<Args>(args_)...);
+    },
+    [](void* dst_, void* src_) noexcept
+    {
+      ::new (dst_) T(std::move(*static_cast<T*>(src_)));
+      static_cast<T*>(src_)->~T();
+    },
+    [](void* buf_) noexcept
+    {
+      static_cast<T*>(buf_)->~T();
+    },
+  };
+
+  template<typename T>
+  static constexpr Ops heap_ops {
+    [](void* buf_, Args&&... args_) -> R
+    {
+      return (**static_cast<T**>(buf_))(std::forward<Args>(args_)...);
+    },
+    [](void* dst_, void* src_) noexcept
+    {
+      *static_cast<T**>(dst_) = *static_cast<T**>(src_);
+    },
+    [](void* buf_) noexcept
+    {
+      delete *static_cast<T**>(buf_);
+    },
+  };
+
+public:
+
+  Callback() noexcept = default;
+
+  Callback(std::nullptr_t) noexcept
+  {
+  }
+
+  template<typename F, typename T = std::decay_t<F>,
+    typename = std::enable_if_t<! std::is_same_v<T, Callback> &&
+    std::is_invocable_r_v<R, T&, Args...>>>
+  Callback(F&& fn_)
+  {
+    // an empty function or null pointer makes an empty callback
+    if constexpr (std::is_pointer_v<T> || std::is_member_pointer_v<T> ||
+      std::is_same_v<T, std::function<R(Args...)>>)
+    {
+      if (! fn_)
+      {
+        return;
+      }
+    }
+
+    if constexpr (is_local<T>)
+    {
+      ::new (static_cast<void*>(&_buf)) T(std::forward<F>(fn_));
+      _ops = &local_ops<T>;
+    }
+    else
+    {
+      ::new (static_cast<void*>(&_buf)) T*(new T(std::forward<F>(fn_)));
+      _ops = &heap_ops<T>;
+    }
+  }
+
+  Callback(Callback&& rhs) noexcept
+  {
+    take(rhs);
+  }
+
+  Callback& operator=(Callback&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      reset();
+      take(rhs);
+    }
+
+    return *this;
+  }
+
+  Callback(Callback const&) = delete;
+  Callback& operator=(Callback const&) = delete;
+
+  ~Callback()
+  {
+    reset();
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return _ops != nullptr;
+  }
+
+  R operator()(Args... args_) const
+  {
+    if (! _ops)
+    {
+      throw std::bad_function_call();
+    }
+
+    return _ops->call(static_cast<void*>(&_buf), std::forward<Args>(args_)...);
+  }
+
+private:
+
+  void take(Callback& rhs) noexcept
+  {
+    if (rhs._ops)
+    {
+      rhs._ops->move(static_cast<void*>(&_buf), static_cast<void*>(&rhs._buf));
+      _ops = std::exchange(rhs._ops, nullptr);
+    }
+  }
+
+  void reset() noexcept
+  {
+    if (_ops)
+    {
+      _ops->destroy(static_cast<void*>(&_buf));
+      _ops = nullptr;
+    }
+  }
+
+  Ops const* _ops {nullptr};
+
+  // invoking a target may change it, as with std::function
+  mutable std::aligned_storage_t<N, alignof(std::max_align_t)> _buf;
+}; // class Callback
+
 namespace Detail
 {
 
@@ -403,128 +566,255 @@ inline std::string to_string(T const& t)
   return ss.str();
 }
 
-} // namespace Detail
+// the bytes url encoding leaves as they are
+inline constexpr auto url_unreserved = []
+{
+  std::array<bool, 256> res {};
+
+  for (int c = '0'; c <= '9'; ++c)
+  {
+    res[static_cast<std::size_t>(c)] = true;
+  }
 
-std::unordered_map<std::string, std::string> const mime_types
+  for (int c = 'a'; c <= 'z'; ++c)
+  {
+    res[static_cast<std::size_t>(c)] = true;
+    res[static_cast<std::size_t>(c - 'a' + 'A')] = true;
+  }
+
+  for (char c : {'-', '_', '.', '~'})
+  {
+    res[static_cast<unsigned char>(c)] = true;
+  }
+
+  return res;
+}();
+
+// the value of each hex digit, -1 for other bytes
+inline constexpr auto hex_value = []
+{
+  std::array<std::int8_t, 256> res {};
+
+  for (auto& e : res)
+  {
+    e = -1;
+  }
+
+  for (int c = 0; c < 10; ++c)
+  {
+    res[static_cast<std::size_t>('0' + c)] = static_cast<std::int8_t>(c);
+  }
+
+  for (int c = 0; c < 6; ++c)
+  {
+    res[static_cast<std::size_t>('a' + c)] = static_cast<std::int8_t>(10 + c);
+    res[static_cast<std::size_t>('A' + c)] = static_cast<std::int8_t>(10 + c);
+  }
+
+  return res;
+}();
+
+// the length of the run of unreserved bytes at the start of 'str'
+inline std::size_t url_unreserved_run(char const* str, std::size_t size)
+{
+  std::size_t i {0};
+
+#if defined(__SSE2__)
+  // 16 bytes at a time, bytes over 0x7f compare as negative and fall outside every range
+  auto const in_range = [](__m128i v, char lo, char hi)
+  {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+      _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+  };
+
+  for (; i + 16 <= size; i += 16)
+  {
+    auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(str + i));
+
+    // setting the case bit folds upper case letters onto lower case
+    auto ok = _mm_or_si128(in_range(v, '0', '9'),
+      in_range(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z'));
+    ok = _mm_or_si128(ok, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('-')),
+      _mm_cmpeq_epi8(v, _mm_set1_epi8('_'))));
+    ok = _mm_or_si128(ok, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('.')),
+      _mm_cmpeq_epi8(v, _mm_set1_epi8('~'))));
+
+    auto const mask = static_cast<unsigned int>(_mm_movemask_epi8(ok));
+
+    if (mask != 0xffff)
+    {
+      return i + static_cast<std::size_t>(__builtin_ctz(~mask));
+    }
+  }
+#endif // __SSE2__
+
+  while (i < size && url_unreserved[static_cast<unsigned char>(str[i])])
+  {
+    ++i;
+  }
+
+  return i;
+}
+
+// the offset of the first '%' or '+' in 'str', or 'size' if there is none
+inline std::size_t url_escape_find(char const* str, std::size_t size)
 {
-  {"html", "text/html"},
-  {"htm", "text/html"},
-  {"shtml", "text/html"},
-  {"css", "text/css"},
-  {"xml", "text/xml"},
-  {"gif", "image/gif"},
-  {"jpg", "image/jpg"},
-  {"jpeg", "image/jpg"},
-  {"js", "application/javascript"},
-  {"atom", "application/atom+xml"},
-  {"rss", "application/rss+xml"},
-  {"mml", "text/mathml"},
-  {"txt", "text/plain"},
-  {"jad", "text/vnd.sun.j2me.app-descriptor"},
-  {"wml", "text/vnd.wap.wml"},
-  {"htc", "text/x-component"},
-  {"png", "image/png"},
-  {"tif", "image/tiff"},
-  {"tiff", "image/tiff"},
-  {"wbmp", "image/vnd.wap.wbmp"},
-  {"ico", "image/x-icon"},
-  {"jng", "image/x-jng"},
-  {"bmp", "image/x-ms-bmp"},
-  {"svg", "image/svg+xml"},
-  {"svgz", "image/svg+xml"},
-  {"webp", "image/webp"},
-  {"woff", "application/font-woff"},
-  {"jar", "application/java-archive"},
-  {"war", "application/java-archive"},
-  {"ear", "application/java-archive"},
-  {"json", "application/json"},
-  {"hqx", "application/mac-binhex40"},
-  {"doc", "application/msword"},
-  {"pdf", "application/pdf"},
-  {"ps", "application/postscript"},
-  {"eps", "application/postscript"},
-  {"ai", "application/postscript"},
-  {"rtf", "application/rtf"},
-  {"m3u8", "application/vnd.apple.mpegurl"},
-  {"xls", "application/vnd.ms-excel"},
-  {"eot", "application/vnd.ms-fontobject"},
-  {"ppt", "application/vnd.ms-powerpoint"},
-  {"wmlc", "application/vnd.wap.wmlc"},
-  {"kml", "application/vnd.google-earth.kml+xml"},
-  {"kmz", "application/vnd.google-earth.kmz"},
-  {"7z", "application/x-7z-compressed"},
-  {"cco", "application/x-cocoa"},
-  {"jardiff", "application/x-java-archive-diff"},
-  {"jnlp", "application/x-java-jnlp-file"},
-  {"run", "application/x-makeself"},
-  {"pm", "application/x-perl"},
-  {"pl", "application/x-perl"},
-  {"pdb", "application/x-pilot"},
-  {"prc", "application/x-pilot"},
-  {"rar", "application/x-rar-compressed"},
-  {"rpm", "application/x-redhat-package-manager"},
-  {"sea", "application/x-sea"},
-  {"swf", "application/x-shockwave-flash"},
-  {"sit", "application/x-stuffit"},
-  {"tk", "application/x-tcl"},
-  {"tcl", "application/x-tcl"},
-  {"crt", "application/x-x509-ca-cert"},
-  {"pem", "application/x-x509-ca-cert"},
-  {"der", "application/x-x509-ca-cert"},
-  {"xpi", "application/x-xpinstall"},
-  {"xhtml", "application/xhtml+xml"},
-  {"xspf", "application/xspf+xml"},
-  {"zip", "application/zip"},
-  {"dll", "application/octet-stream"},
-  {"exe", "application/octet-stream"},
-  {"bin", "application/octet-stream"},
-  {"deb", "application/octet-stream"},
-  {"dmg", "application/octet-stream"},
-  {"img", "application/octet-stream"},
-  {"iso", "application/octet-stream"},
-  {"msm", "application/octet-stream"},
-  {"msp", "application/octet-stream"},
-  {"msi", "application/octet-stream"},
-  {"docx", "application/vnd.openxmlformats-officedocument.wordprocessingml.document"},
-  {"xlsx", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"},
-  {"pptx", "application/vnd.openxmlformats-officedocument.presentationml.presentation"},
-  {"kar", "audio/midi"},
-  {"midi", "audio/midi"},
-  {"mid", "audio/midi"},
-  {"mp3", "audio/mpeg"},
-  {"ogg", "audio/ogg"},
-  {"m4a", "audio/x-m4a"},
-  {"ra", "audio/x-realaudio"},
-  {"3gp", "video/3gpp"},
-  {"3gpp", "video/3gpp"},
-  {"ts", "video/mp2t"},
-  {"mp4", "video/mp4"},
-  {"mpg", "video/mpeg"},
-  {"mpeg", "video/mpeg"},
-  {"mov", "video/quicktime"},
-  {"webm", "video/webm"},
-  {"flv", "video/x-flv"},
-  {"m4v", "video/x-m4v"},
-  {"mng", "video/x-mng"},
-  {"asf", "video/x-ms-asf"},
-  {"asx", "video/x-ms-asf"},
-  {"wmv", "video/x-ms-wmv"},
-  {"avi", "video/x-msvideo"},
-};
+  std::size_t i {0};
+
+#if defined(__SSE2__)
+  for (; i + 16 <= size; i += 16)
+  {
+    auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(str + i));
+    auto const mask = static_cast<unsigned int>(_mm_movemask_epi8(
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('%')),
+      _mm_cmpeq_epi8(v, _mm_set1_epi8('+')))));
+
+    if (mask)
+    {
+      return i + static_cast<std::size_t>(__builtin_ctz(mask));
+    }
+  }
+#endif // __SSE2__
+
+  while (i < size && str[i] != '%' && str[i] != '+')
+  {
+    ++i;
+  }
+
+  return i;
+}
+
+} // namespace Detail
 
 // prototypes
+inline std::unordered_map<std::string, std::string> const& mime_types();
 inline std::string mime_type(std::string const& path);
 
+// map file extensions to mime types
+// constructed on first use to avoid the cost at program startup
+inline std::unordered_map<std::string, std::string> const& mime_types()
+{
+  static std::unordered_map<std::string, std::string> const types
+  {
+    {"html", "text/html"},
+    {"htm", "text/html"},
+    {"shtml", "text/html"},
+    {"css", "text/css"},
+    {"xml", "text/xml"},
+    {"gif", "image/gif"},
+    {"jpg", "image/jpg"},
+    {"jpeg", "image/jpg"},
+    {"js", "application/javascript"},
+    {"atom", "application/atom+xml"},
+    {"rss", "application/rss+xml"},
+    {"mml", "text/mathml"},
+    {"txt", "text/plain"},
+    {"jad", "text/vnd.sun.j2me.app-descriptor"},
+    {"wml", "text/vnd.wap.wml"},
+    {"htc", "text/x-component"},
+    {"png", "image/png"},
+    {"tif", "image/tiff"},
+    {"tiff", "image/tiff"},
+    {"wbmp", "image/vnd.wap.wbmp"},
+    {"ico", "image/x-icon"},
+    {"jng", "image/x-jng"},
+    {"bmp", "image/x-ms-bmp"},
+    {"svg", "image/svg+xml"},
+    {"svgz", "image/svg+xml"},
+    {"webp", "image/webp"},
+    {"woff", "application/font-woff"},
+    {"jar", "application/java-archive"},
+    {"war", "application/java-archive"},
+    {"ear", "application/java-archive"},
+    {"json", "application/json"},
+    {"hqx", "application/mac-binhex40"},
+    {"doc", "application/msword"},
+    {"pdf", "application/pdf"},
+    {"ps", "application/postscript"},
+    {"eps", "application/postscript"},
+    {"ai", "application/postscript"},
+    {"rtf", "application/rtf"},
+    {"m3u8", "application/vnd.apple.mpegurl"},
+    {"xls", "application/vnd.ms-excel"},
+    {"eot", "application/vnd.ms-fontobject"},
+    {"ppt", "application/vnd.ms-powerpoint"},
+    {"wmlc", "application/vnd.wap.wmlc"},
+    {"kml", "application/vnd.google-earth.kml+xml"},
+    {"kmz", "application/vnd.google-earth.kmz"},
+    {"7z", "application/x-7z-compressed"},
+    {"cco", "application/x-cocoa"},
+    {"jardiff", "application/x-java-archive-diff"},
+    {"jnlp", "application/x-java-jnlp-file"},
+    {"run", "application/x-makeself"},
+    {"pm", "application/x-perl"},
+    {"pl", "application/x-perl"},
+    {"pdb", "application/x-pilot"},
+    {"prc", "application/x-pilot"},
+    {"rar", "application/x-rar-compressed"},
+    {"rpm", "application/x-redhat-package-manager"},
+    {"sea", "application/x-sea"},
+    {"swf", "application/x-shockwave-flash"},
+    {"sit", "application/x-stuffit"},
+    {"tk", "application/x-tcl"},
+    {"tcl", "application/x-tcl"},
+    {"crt", "application/x-x509-ca-cert"},
+    {"pem", "application/x-x509-ca-cert"},
+    {"der", "application/x-x509-ca-cert"},
+    {"xpi", "application/x-xpinstall"},
+    {"xhtml", "application/xhtml+xml"},
+    {"xspf", "application/xspf+xml"},
+    {"zip", "application/zip"},
+    {"dll", "application/octet-stream"},
+    {"exe", "application/octet-stream"},
+    {"bin", "application/octet-stream"},
+    {"deb", "application/octet-stream"},
+    {"dmg", "application/octet-stream"},
+    {"img", "application/octet-stream"},
+    {"iso", "application/octet-stream"},
+    {"msm", "application/octet-stream"},
+    {"msp", "application/octet-stream"},
+    {"msi", "application/octet-stream"},
+    {"docx", "application/vnd.openxmlformats-officedocument.wordprocessingml.document"},
+    {"xlsx", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"},
+    {"pptx", "application/vnd.openxmlformats-officedocument.presentationml.presentation"},
+    {"kar", "audio/midi"},
+    {"midi", "audio/midi"},
+    {"mid", "audio/midi"},
+    {"mp3", "audio/mpeg"},
+    {"ogg", "audio/ogg"},
+    {"m4a", "audio/x-m4a"},
+    {"ra", "audio/x-realaudio"},
+    {"3gp", "video/3gpp"},
+    {"3gpp", "video/3gpp"},
+    {"ts", "video/mp2t"},
+    {"mp4", "video/mp4"},
+    {"mpg", "video/mpeg"},
+    {"mpeg", "video/mpeg"},
+    {"mov", "video/quicktime"},
+    {"webm", "video/webm"},
+    {"flv", "video/x-flv"},
+    {"m4v", "video/x-m4v"},
+    {"mng", "video/x-mng"},
+    {"asf", "video/x-ms-asf"},
+    {"asx", "video/x-ms-asf"},
+    {"wmv", "video/x-ms-wmv"},
+    {"avi", "video/x-msvideo"},
+  };
+
+  return types;
+}
+
 // find the mime type of a string path
 inline std::string mime_type(std::string const& path)
 {
   if (auto ext = Detail::extension(path))
   {
     auto const str = Detail::lowercase(ext.value());
+    auto const& types = mime_types();
 
-    if (mime_types.find(str) != mime_types.end())
+    if (auto const it = types.find(str); it != types.end())
     {
-      return mime_types.at(str);
+      return it->second;
     }
   }
 
@@ -588,13 +878,25 @@ public:
 
     if (! _params.empty())
     {
-      path += "?";
-      auto it = _params.begin();
-      for (; it != _params.end(); ++it)
+      // size the target first so it is written without growing
+      auto size = path.size();
+
+      for (auto const& [key, val] : _params)
+      {
+        size += 2 + url_encode_size(key) + url_encode_size(val);
+      }
+
+      path.reserve(size);
+
+      char delim {'?'};
+
+      for (auto const& [key, val] : _params)
       {
-        path += url_encode(it->first) + "=" + url_encode(it->second) + "&";
+        path += std::exchange(delim, '&');
+        url_encode(path, key);
+        path += '=';
+        url_encode(path, val);
       }
-      path.pop_back();
     }
 
     target(path);
@@ -639,84 +941,95 @@ public:
 
 private:
 
-  std::string hex_encode(char const c)
+  // the size of a string once url encoded
+  std::size_t url_encode_size(std::string const& str)
   {
-    char s[3];
+    std::size_t size {str.size()};
 
-    if (c & 0x80)
-    {
-      std::snprintf(&s[0], 3, "%02X",
-        static_cast<unsigned int>(c & 0xff)
-      );
-    }
-    else
+    for (std::size_t i = 0; i < str.size(); ++i)
     {
-      std::snprintf(&s[0], 3, "%02X",
-        static_cast<unsigned int>(c)
-      );
-    }
-
-    return std::string(s);
-  }
+      i += Detail::url_unreserved_run(str.data() + i, str.size() - i);
 
-  char hex_decode(std::string const& s)
-  {
-    unsigned int n;
-
-    std::sscanf(s.data(), "%x", &n);
+      // an escape takes two more bytes, a space is written as '+'
+      if (i < str.size() && str[i] != ' ')
+      {
+        size += 2;
+      }
+    }
 
-    return static_cast<char>(n);
+    return size;
   }
 
-  std::string url_encode(std::string const& str)
+  // append the url encoded string to 'res'
+  // runs of unreserved bytes are copied whole
+  void url_encode(std::string& res, std::string const& str)
   {
-    std::string res;
-    res.reserve(str.size());
+    static constexpr char hex[] {"0123456789ABCDEF"};
 
-    for (auto const& e : str)
+    for (std::size_t i = 0; i < str.size(); ++i)
     {
-      if (e == ' ')
+      auto const run = Detail::url_unreserved_run(str.data() + i, str.size() - i);
+      res.append(str, i, run);
+      i += run;
+
+      if (i == str.size())
       {
-        res += "+";
+        break;
       }
-      else if (std::isalnum(static_cast<unsigned char>(e)) ||
-        e == '-' || e == '_' || e == '.' || e == '~')
+
+      auto const c = static_cast<unsigned char>(str[i]);
+
+      if (c == ' ')
       {
-        res += e;
+        res += '+';
       }
       else
       {
-        res += "%" + hex_encode(e);
+        char const esc[] {'%', hex[c >> 4], hex[c & 0xf]};
+        res.append(esc, 3);
       }
     }
-
-    return res;
   }
 
   std::string url_decode(std::string const& str)
   {
-    std::string res;
-    res.reserve(str.size());
+    // decoding never makes the string longer
+    std::string res (str.size(), '\0');
+    auto out = res.begin();
 
     for (std::size_t i = 0; i < str.size(); ++i)
     {
+      auto const run = Detail::url_escape_find(str.data() + i, str.size() - i);
+      out = std::copy_n(str.begin() + static_cast<std::ptrdiff_t>(i), run, out);
+      i += run;
+
+      if (i == str.size())
+      {
+        break;
+      }
+
+      auto const hi = i + 2 < str.size() ?
+        Detail::hex_value[static_cast<unsigned char>(str[i + 1])] : -1;
+      auto const lo = i + 2 < str.size() ?
+        Detail::hex_value[static_cast<unsigned char>(str[i + 2])] : -1;
+
       if (str[i] == '+')
       {
-        res += " ";
+        *out++ = ' ';
       }
-      else if (str[i] == '%' && i + 2 < str.size() &&
-        std::isxdigit(static_cast<unsigned char>(str[i + 1])) &&
-        std::isxdigit(static_cast<unsigned char>(str[i + 2])))
+      else if (hi >= 0 && lo >= 0)
       {
-        res += hex_decode(str.substr(i + 1, 2));
+        *out++ = static_cast<char>(hi << 4 | lo);
         i += 2;
       }
       else
       {
-        res += str[i];
+        *out++ = str[i];
       }
     }
 
+    res.erase(out, res.end());
+
     return res;
   }
 
@@ -2226,18 +2539,50 @@ public:
   }; // struct Error_Ctx
 
   // callbacks
-  using fn_on_http = std::function<void(Http_Ctx&)>;
+  // a request holds its callbacks in place, so queueing it does not allocate for them
+  using fn_on_http = Callback<void(Http_Ctx&)>;
+  using fn_on_http_body = Callback<void(Http_Ctx&, std::string_view)>;
   using fn_on_http_error = std::function<void(Error_Ctx&)>;
 
   struct Req_Ctx
   {
+    Req_Ctx() = default;
+
+    Req_Ctx(Request&& req_, fn_on_http&& on_http_, fn_on_http_body&& on_http_body_ = {}) :
+      req {std::move(req_)},
+      on_http {std::move(on_http_)},
+      on_http_body {std::move(on_http_body_)}
+    {
+    }
+
     // http request object
     Request req {};
 
     // http callback
     fn_on_http on_http {};
+
+    // optional http body callback
+    // when set, the body is passed to it in pieces as they arrive instead of
+    // being stored in the response, the response header is set before the first call
+    fn_on_http_body on_http_body {};
   }; // struct Req_Ctx
 
+  // storage reused by each request of a client, so a run of requests
+  // stops allocating once the buffers have grown to fit its responses
+  // clients sharing a pool must not be connected at the same time
+  struct Pool
+  {
+    // read buffer of the connection
+    beast::flat_buffer buf {};
+
+    // a streamed body is read into this a piece at a time
+    std::string chunk {};
+
+    // the body of the next response, the string_body reader reserves it
+    // from the content length, a body left in the response by the callback comes back here
+    std::string body {};
+  }; // struct Pool
+
   struct Attr
   {
 #ifdef OB_BELLE_CONFIG_SSL_ON
@@ -2257,11 +2602,22 @@ public:
     // port to connect to
     unsigned short port {8080};
 
+    // keep the connection open after the last request in the queue,
+    // more requests can be queued from a callback, or before the next call to connect,
+    // and are sent on it
+    bool keep_alive {false};
+
+    // set while a kept alive connection waits for a request, sends the queue on it
+    Callback<void()> idle {};
+
     // http request queue
     std::deque<Req_Ctx> que;
 
     // http error callback
     fn_on_http_error on_http_error {};
+
+    // buffers and bodies reused between requests
+    std::shared_ptr<Pool> pool {std::make_shared<Pool>()};
   }; // struct Attr
 
   template<typename Derived>
@@ -2275,11 +2631,17 @@ public:
   public:
 
     Http_Base(net::io_context& io_, std::shared_ptr<Attr> attr_) :
+      _io {io_},
       _resolver {io_},
       _strand {io_.get_executor()},
       _timer {io_, (std::chrono::steady_clock::time_point::max)()},
-      _attr {attr_}
+      _attr {attr_},
+      _pool {_attr->pool},
+      _buf {_pool->buf},
+      _chunk {_pool->chunk}
     {
+      // drop bytes left over from an earlier connection
+      _buf.clear();
     }
 
     ~Http_Base()
@@ -2378,6 +2740,10 @@ public:
       _ctx = {};
       _ctx.req = &_attr->que.front().req;
 
+      // read into the pooled body, emptied but keeping its capacity
+      _ctx.res.body() = std::move(_pool->body);
+      _ctx.res.body().clear();
+
       // serialize target and params
       _ctx.req->params_serialize();
 
@@ -2394,7 +2760,7 @@ public:
       }
 
       // set connection close if last request in the queue
-      if (_attr->que.size() == 1)
+      if (_attr->que.size() == 1 && ! _attr->keep_alive)
       {
         _ctx.req->keep_alive(false);
       }
@@ -2426,9 +2792,7 @@ public:
 
       if (ec_)
       {
-        cancel_timer();
-        Error_Ctx err {ec_};
-        _attr->on_http_error(err);
+        fail(ec_);
         return;
       }
 
@@ -2437,6 +2801,13 @@ public:
 
     void do_read()
     {
+      if (_attr->que.front().on_http_body)
+      {
+        do_read_header();
+
+        return;
+      }
+
       // Receive the HTTP response
       http::async_read(derived().socket(), _buf, _ctx.res,
         net::bind_executor(_strand,
@@ -2454,35 +2825,169 @@ public:
 
       if (ec_)
       {
-        cancel_timer();
-        Error_Ctx err {ec_};
-        _attr->on_http_error(err);
+        fail(ec_);
+        return;
+      }
+
+      do_done();
+    }
+
+    void do_read_header()
+    {
+      // the body is read into a fixed size buffer and handed to the callback
+      // a piece at a time, so memory use does not grow with the body size
+      _parser.emplace();
+      _parser->body_limit((std::numeric_limits<std::uint64_t>::max)());
+      _chunk.resize(_chunk_size);
+
+      http::async_read_header(derived().socket(), _buf, *_parser,
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this()](error_code ec, std::size_t bytes)
+          {
+            self->on_read_header(ec, bytes);
+          }
+        )
+      );
+    }
+
+    void on_read_header(error_code ec_, std::size_t bytes_)
+    {
+      boost::ignore_unused(bytes_);
+
+      if (ec_)
+      {
+        fail(ec_);
+        return;
+      }
+
+      // a response has started, it is not sent again
+      _reused = false;
+
+      // the body went to the callback, only the header is kept
+      _ctx.res.base() = _parser->get().base();
+
+      if (_parser->is_done())
+      {
+        _parser.reset();
+        do_done();
+
+        return;
+      }
+
+      do_read_body();
+    }
+
+    void do_read_body()
+    {
+      _parser->get().body().data = _chunk.data();
+      _parser->get().body().size = _chunk.size();
+
+      http::async_read_some(derived().socket(), _buf, *_parser,
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this()](error_code ec, std::size_t bytes)
+          {
+            self->on_read_body(ec, bytes);
+          }
+        )
+      );
+    }
+
+    void on_read_body(error_code ec_, std::size_t bytes_)
+    {
+      boost::ignore_unused(bytes_);
+
+      // a full buffer is reported as need_buffer
+      if (ec_ && ec_ != http::error::need_buffer)
+      {
+        fail(ec_);
+        return;
+      }
+
+      auto const size = _chunk.size() - _parser->get().body().size;
+
+      if (size)
+      {
+        _attr->que.front().on_http_body(_ctx, std::string_view(_chunk.data(), size));
+      }
+
+      if (! _parser->is_done())
+      {
+        do_read_body();
+
         return;
       }
 
+      _parser.reset();
+      do_done();
+    }
+
+    void do_done()
+    {
       // run user function
       _attr->que.front().on_http(_ctx);
 
+      // keep the body for the next response unless the callback took it
+      if (_ctx.res.body().capacity() > _pool->body.capacity())
+      {
+        _pool->body = std::move(_ctx.res.body());
+      }
+
       // remove request from queue
       _attr->que.pop_front();
 
-      if (_attr->que.empty())
+      if (! _attr->que.empty())
       {
-        derived().do_close();
+        do_write();
+      }
+      else if (_attr->keep_alive && _ctx.res.keep_alive())
+      {
+        // wait for the next request without holding any pending operation,
+        // the callback keeps the connection alive
+        _attr->idle = [self = derived().shared_from_this()]
+        {
+          self->_reused = true;
+          self->do_write();
+        };
       }
       else
       {
-        do_write();
+        derived().do_close();
+      }
+    }
+
+    // report an error, unless the request went out on a connection that had been idle,
+    // which the server may have closed in the meantime, then it is sent again on a new one
+    void fail(error_code ec_)
+    {
+      cancel_timer();
+
+      if (std::exchange(_reused, false))
+      {
+        std::make_shared<Derived>(_io, _attr)->run();
+        return;
       }
+
+      Error_Ctx err {ec_};
+      _attr->on_http_error(err);
     }
 
+    net::io_context& _io;
     tcp::resolver _resolver;
     net::strand<net::io_context::executor_type> _strand;
     net::steady_timer _timer;
     std::shared_ptr<Attr> _attr;
+    std::shared_ptr<Pool> _pool;
     Http_Ctx _ctx {};
-    beast::flat_buffer _buf {};
+    beast::flat_buffer& _buf;
     bool _close {false};
+
+    // the request in flight was sent on a connection that had been idle
+    bool _reused {false};
+
+    // used when the body is streamed to a callback
+    static constexpr std::size_t _chunk_size {16384};
+    std::optional<http::response_parser<http::buffer_body>> _parser;
+    std::string& _chunk;
   }; // class Http_Base
 
   class Http :
@@ -2719,6 +3224,8 @@ public:
   // destructor
   ~Client()
   {
+    // close an idle connection while the io_context it uses is still alive
+    _attr->idle = {};
   }
 
   // set the address to connect to
@@ -2749,6 +3256,20 @@ public:
     return _attr->port;
   }
 
+  // set keep alive for the last request in the queue
+  Client& keep_alive(bool keep_alive_)
+  {
+    _attr->keep_alive = keep_alive_;
+
+    return *this;
+  }
+
+  // get keep alive for the last request in the queue
+  bool keep_alive()
+  {
+    return _attr->keep_alive;
+  }
+
   // set the socket timeout
   Client& timeout(std::chrono::seconds timeout_)
   {
@@ -2777,6 +3298,20 @@ public:
     return _timeout_max;
   }
 
+  // set the pool of buffers, clients given the same pool reuse each other's buffers
+  Client& pool(std::shared_ptr<Pool> pool_)
+  {
+    _attr->pool = pool_;
+
+    return *this;
+  }
+
+  // get the pool of buffers
+  std::shared_ptr<Pool> pool()
+  {
+    return _attr->pool;
+  }
+
   // get request queue
   std::deque<Req_Ctx>& queue()
   {
@@ -2820,85 +3355,93 @@ public:
 
   Client& on_http(Request const& req_, fn_on_http on_http_)
   {
-    _attr->que.emplace_back(Req_Ctx());
-    auto& ctx = _attr->que.back();
-
-    ctx.req = req_;
-    ctx.on_http = on_http_;
+    _attr->que.emplace_back(Request(req_), std::move(on_http_));
+    resume();
 
     return *this;
   }
 
   Client& on_http(Request&& req_, fn_on_http on_http_)
   {
-    _attr->que.emplace_back(Req_Ctx());
-    auto& ctx = _attr->que.back();
+    _attr->que.emplace_back(std::move(req_), std::move(on_http_));
+    resume();
+
+    return *this;
+  }
 
-    ctx.req = std::move(req_);
-    ctx.on_http = on_http_;
+  // stream the response body to 'on_http_body' as it arrives,
+  // then call 'on_http' with the response header and an empty body
+  Client& on_http(Request&& req_, fn_on_http_body on_http_body_, fn_on_http on_http_)
+  {
+    _attr->que.emplace_back(std::move(req_), std::move(on_http_), std::move(on_http_body_));
+    resume();
 
     return *this;
   }
 
   Client& on_http(std::string const& target_, fn_on_http on_http_)
   {
-    this->on_http_impl(Method::get, target_, Request::Params(), Headers(), {}, on_http_);
+    this->on_http_impl(Method::get, target_, {}, {}, {}, std::move(on_http_));
 
     return *this;
   }
 
-  Client& on_http(std::string const& target_, Request::Params const& params_, fn_on_http on_http_)
+  Client& on_http(std::string const& target_, Request::Params params_, fn_on_http on_http_)
   {
-    this->on_http_impl(Method::get, target_, params_, Headers(), {}, on_http_);
+    this->on_http_impl(Method::get, target_, std::move(params_), {}, {}, std::move(on_http_));
 
     return *this;
   }
 
-  Client& on_http(std::string const& target_, Headers const& headers_, fn_on_http on_http_)
+  Client& on_http(std::string const& target_, Headers headers_, fn_on_http on_http_)
   {
-    this->on_http_impl(Method::get, target_, Request::Params(), headers_, {}, on_http_);
+    this->on_http_impl(Method::get, target_, {}, std::move(headers_), {}, std::move(on_http_));
 
     return *this;
   }
 
-  Client& on_http(std::string const& target_, Request::Params const& params_, Headers const& headers_, fn_on_http on_http_)
+  Client& on_http(std::string const& target_, Request::Params params_, Headers headers_, fn_on_http on_http_)
   {
-    this->on_http_impl(Method::get, target_, params_, headers_, {}, on_http_);
+    this->on_http_impl(Method::get, target_, std::move(params_), std::move(headers_), {},
+      std::move(on_http_));
 
     return *this;
   }
 
   Client& on_http(Method method_, std::string const& target_,
-    std::string const& body_, fn_on_http on_http_)
+    std::string body_, fn_on_http on_http_)
   {
-    this->on_http_impl(method_, target_, Request::Params(), Headers(), body_, on_http_);
+    this->on_http_impl(method_, target_, {}, {}, std::move(body_), std::move(on_http_));
 
     return *this;
   }
 
   Client& on_http(Method method_, std::string const& target_,
-    Request::Params const& params_,
-    std::string const& body_, fn_on_http on_http_)
+    Request::Params params_,
+    std::string body_, fn_on_http on_http_)
   {
-    this->on_http_impl(method_, target_, params_, Headers(), body_, on_http_);
+    this->on_http_impl(method_, target_, std::move(params_), {}, std::move(body_),
+      std::move(on_http_));
 
     return *this;
   }
 
   Client& on_http(Method method_, std::string const& target_,
-    Headers const& headers_,
-    std::string const& body_, fn_on_http on_http_)
+    Headers headers_,
+    std::string body_, fn_on_http on_http_)
   {
-    this->on_http_impl(method_, target_, Request::Params(), headers_, body_, on_http_);
+    this->on_http_impl(method_, target_, {}, std::move(headers_), std::move(body_),
+      std::move(on_http_));
 
     return *this;
   }
 
   Client& on_http(Method method_, std::string const& target_,
-    Request::Params const& params_, Headers const& headers_,
-    std::string const& body_, fn_on_http on_http_)
+    Request::Params params_, Headers headers_,
+    std::string body_, fn_on_http on_http_)
   {
-    this->on_http_impl(method_, target_, params_, headers_, body_, on_http_);
+    this->on_http_impl(method_, target_, std::move(params_), std::move(headers_),
+      std::move(body_), std::move(on_http_));
 
     return *this;
   }
@@ -2917,31 +3460,52 @@ public:
       return 0;
     }
 
-#ifdef OB_BELLE_CONFIG_SSL_ON
-    if (_attr->ssl)
+    if (_attr->idle)
     {
-      // use https
-      std::make_shared<Https>(_io, _attr)->run();
+      // send the queue on the connection kept alive by the last call
+      std::exchange(_attr->idle, {})();
     }
     else
-#endif // OB_BELLE_CONFIG_SSL_ON
     {
-      // use http
-      std::make_shared<Http>(_io, _attr)->run();
+#ifdef OB_BELLE_CONFIG_SSL_ON
+      if (_attr->ssl)
+      {
+        // use https
+        std::make_shared<Https>(_io, _attr)->run();
+      }
+      else
+#endif // OB_BELLE_CONFIG_SSL_ON
+      {
+        // use http
+        std::make_shared<Http>(_io, _attr)->run();
+      }
     }
 
     std::size_t size_begin {_attr->que.size()};
 
-    if (_timeout_max > std::chrono::milliseconds(0))
+    // requests queued from a callback wake an idle connection
+    _running = true;
+
+    try
     {
-      // run for max 'n' amount of time
-      _io.run_until(std::chrono::steady_clock::now() + _timeout_max);
+      if (_timeout_max > std::chrono::milliseconds(0))
+      {
+        // run for max 'n' amount of time
+        _io.run_until(std::chrono::steady_clock::now() + _timeout_max);
+      }
+      else
+      {
+        _io.run();
+      }
     }
-    else
+    catch (...)
     {
-      _io.run();
+      _running = false;
+      throw;
     }
 
+    _running = false;
+
     // reset the io_context
     _io.restart();
 
@@ -2952,22 +3516,31 @@ public:
 
 private:
 
+  // build the request in place in the queue from the moved arguments
   Client& on_http_impl(Method method_, std::string const& target_,
-    Request::Params const& params_, Headers const& headers_,
-    std::string const& body_, fn_on_http on_http_)
+    Request::Params&& params_, Headers&& headers_,
+    std::string&& body_, fn_on_http&& on_http_)
   {
-    _attr->que.emplace_back(Req_Ctx());
-    auto& ctx = _attr->que.back();
+    auto& ctx = _attr->que.emplace_back(
+      Request(method_, target_, 11, std::move(body_), std::move(headers_)),
+      std::move(on_http_));
 
-    Request req {method_, target_, 11, body_, headers_};
-    req.params() = params_;
-
-    ctx.req = std::move(req);
-    ctx.on_http = on_http_;
+    ctx.req.params() = std::move(params_);
+    resume();
 
     return *this;
   }
 
+  // send a request queued from a callback on the idle connection
+  // outside of connect, the queue waits for the next call
+  void resume()
+  {
+    if (_running && _attr->idle)
+    {
+      std::exchange(_attr->idle, {})();
+    }
+  }
+
   // hold the client attributes
   std::shared_ptr<Attr> _attr {std::make_shared<Attr>()};
 
@@ -2976,6 +3549,9 @@ private:
 
   // timeout all requests after specified number of milliseconds
   std::chrono::milliseconds _timeout_max {0};
+
+  // connect is running the io_context
+  bool _running {false};
 }; // class Client
 #endif // OB_BELLE_CONFIG_CLIENT_ON
 
@@ -0,0 +1,146 @@
+#ifndef OB_MMAP_HH
+#define OB_MMAP_HH
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace OB
+{
+
+// read only memory map of a whole file
+class Mmap
+{
+public:
+
+  Mmap()
+  {
+  }
+
+  explicit Mmap(std::string const& path_)
+  {
+    open(path_);
+  }
+
+  Mmap(Mmap const&) = delete;
+
+  Mmap(Mmap&& rhs_) noexcept :
+    _data {std::exchange(rhs_._data, nullptr)},
+    _size {std::exchange(rhs_._size, 0)},
+    _open {std::exchange(rhs_._open, false)}
+  {
+  }
+
+  Mmap& operator=(Mmap const&) = delete;
+
+  Mmap& operator=(Mmap&& rhs_) noexcept
+  {
+    if (this != &rhs_)
+    {
+      close();
+      _data = std::exchange(rhs_._data, nullptr);
+      _size = std::exchange(rhs_._size, 0);
+      _open = std::exchange(rhs_._open, false);
+    }
+
+    return *this;
+  }
+
+  ~Mmap()
+  {
+    close();
+  }
+
+  // map the file at 'path', returns false on failure
+  // an empty file is mapped successfully with a size of zero
+  bool open(std::string const& path_)
+  {
+    close();
+
+    int const fd {::open(path_.c_str(), O_RDONLY | O_CLOEXEC)};
+
+    if (fd == -1)
+    {
+      return false;
+    }
+
+    struct stat st;
+
+    if (fstat(fd, &st) == -1)
+    {
+      ::close(fd);
+      return false;
+    }
+
+    _size = static_cast<std::size_t>(st.st_size);
+
+    if (_size)
+    {
+      void* ptr {mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0)};
+
+      if (ptr == MAP_FAILED)
+      {
+        ::close(fd);
+        _size = 0;
+        return false;
+      }
+
+      _data = ptr;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+    _open = true;
+
+    return true;
+  }
+
+  void close()
+  {
+    if (_data)
+    {
+      munmap(_data, _size);
+    }
+
+    _data = nullptr;
+    _size = 0;
+    _open = false;
+  }
+
+  char const* data() const
+  {
+    return static_cast<char const*>(_data);
+  }
+
+  std::size_t size() const
+  {
+    return _size;
+  }
+
+  std::string_view view() const
+  {
+    return {data(), _size};
+  }
+
+  explicit operator bool() const
+  {
+    return _open;
+  }
+
+private:
+
+  void* _data {nullptr};
+  std::size_t _size {0};
+  bool _open {false};
+}; // class Mmap
+
+} // namespace OB
+
+#endif // OB_MMAP_HH
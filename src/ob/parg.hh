@@ -27,19 +27,22 @@
 
 #include <unistd.h>
 
-#include <cctype>
 #include <cstddef>
-#include <cstdlib>
+#include <cstdint>
 #include <cassert>
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <iostream>
-#include <map>
+#include <iterator>
 #include <vector>
+#include <array>
 #include <utility>
-#include <regex>
 #include <algorithm>
+#include <charconv>
+#include <system_error>
+#include <stdexcept>
 #include <type_traits>
 
 namespace OB
@@ -47,125 +50,404 @@ namespace OB
 class Parg
 {
 public:
+
+  // maximum number of flags and options in a table
+  static constexpr std::size_t max_options {64};
+
+  // maximum size of a long name
+  static constexpr std::size_t max_name {64};
+
+  // marks an empty slot in a lookup table
+  static constexpr std::uint8_t none {0xff};
+
+  struct Option
+  {
+    // long name
+    std::string_view long_ {};
+
+    // short name, '\0' when not present
+    char short_ {'\0'};
+
+    // true for a flag, false for an option that takes an argument
+    bool mode_ {true};
+
+    // default value
+    std::string_view value_ {};
+
+    // name of the argument shown in the help output
+    std::string_view arg_ {};
+
+    // description shown in the help output
+    std::string_view info_ {};
+  }; // struct Option
+
+  // read only view of a table
+  struct Index
+  {
+    // flags and options in declaration order
+    Option const* data {nullptr};
+    std::size_t size {0};
+
+    // long name perfect hash, slot to option position
+    std::uint8_t const* longs {nullptr};
+    std::size_t mask {0};
+    std::uint64_t seed {0};
+
+    // ascii short name to option position
+    std::uint8_t const* shorts {nullptr};
+  }; // struct Index
+
+  // 64-bit FNV-1a hash of 'str' perturbed by 'seed'
+  static constexpr std::uint64_t hash(std::string_view const _str, std::uint64_t const _seed)
+  {
+    std::uint64_t h {0xcbf29ce484222325 ^ (_seed * 0x9e3779b97f4a7c15)};
+
+    for (auto const c : _str)
+    {
+      h ^= static_cast<unsigned char>(c);
+      h *= 0x100000001b3;
+    }
+
+    return h ^ (h >> 29);
+  }
+
+  // a fixed set of flags and options with lookup tables generated at compile time
+  // long names are found through a perfect hash, short names through a direct table
+  template<std::size_t N>
+  class Table
+  {
+    static_assert(N > 0 && N < max_options, "parg table size is out of range");
+
+  public:
+
+    // number of slots in the long name table, a power of two at least four times N
+    static constexpr std::size_t slots {[] {
+      std::size_t n {1};
+      while (n < N * 4) n <<= 1;
+      return n;
+    }()};
+
+    constexpr explicit Table(std::array<Option, N> const& _opts) :
+      opts_ {_opts}
+    {
+      for (auto& e : shorts_)
+      {
+        e = none;
+      }
+
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        auto const& opt = opts_[i];
+
+        if (opt.long_.empty() || opt.long_.size() > max_name)
+        {
+          throw std::logic_error("parg option name is invalid");
+        }
+
+        for (std::size_t j = 0; j < i; ++j)
+        {
+          if (opts_[j].long_ == opt.long_)
+          {
+            throw std::logic_error("parg option name is defined twice");
+          }
+        }
+
+        if (opt.short_ != '\0')
+        {
+          auto const c = static_cast<unsigned char>(opt.short_);
+
+          if (c >= shorts_.size() || shorts_[c] != none)
+          {
+            throw std::logic_error("parg short name is invalid or defined twice");
+          }
+
+          shorts_[c] = static_cast<std::uint8_t>(i);
+        }
+      }
+
+      // search for a seed that maps every long name to a distinct slot
+      for (std::uint64_t seed = 0; seed < 4096; ++seed)
+      {
+        bool found {true};
+
+        for (auto& e : longs_)
+        {
+          e = none;
+        }
+
+        for (std::size_t i = 0; i < N; ++i)
+        {
+          auto& slot = longs_[hash(opts_[i].long_, seed) & (slots - 1)];
+
+          if (slot != none)
+          {
+            found = false;
+            break;
+          }
+
+          slot = static_cast<std::uint8_t>(i);
+        }
+
+        if (found)
+        {
+          seed_ = seed;
+          return;
+        }
+      }
+
+      throw std::logic_error("parg could not generate a perfect hash");
+    }
+
+    constexpr Index index() const
+    {
+      return {opts_.data(), N, longs_.data(), slots - 1, seed_, shorts_.data()};
+    }
+
+  private:
+
+    std::array<Option, N> opts_ {};
+    std::array<std::uint8_t, slots> longs_ {};
+    std::array<std::uint8_t, 128> shorts_ {};
+    std::uint64_t seed_ {0};
+  }; // class Table
+
+  // declare a flag, 'name' is either 'long', 'long,s', or 's'
+  static constexpr Option flag(std::string_view const _name, std::string_view const _info)
+  {
+    auto opt = names(_name);
+    opt.mode_ = true;
+    opt.value_ = "0";
+    opt.info_ = _info;
+
+    return opt;
+  }
+
+  // declare an option that takes an argument, 'name' is either 'long', 'long,s', or 's'
+  static constexpr Option option(std::string_view const _name, std::string_view const _default,
+    std::string_view const _arg, std::string_view const _info)
+  {
+    auto opt = names(_name);
+    opt.mode_ = false;
+    opt.value_ = _default;
+    opt.arg_ = _arg;
+    opt.info_ = _info;
+
+    return opt;
+  }
+
+  // build a table from a list of flags and options
+  template<typename... T>
+  static constexpr Table<sizeof...(T)> table(T const&... _opts)
+  {
+    return Table<sizeof...(T)>(std::array<Option, sizeof...(T)> {_opts...});
+  }
+
+  // Levenshtein distance between 'lhs' and 'rhs', ignoring ascii case
+  // uses the bit-parallel algorithm of Myers as formulated by Hyyrö,
+  // 'lhs' must be no longer than 64 characters
+  static std::size_t distance(std::string_view const _lhs, std::string_view const _rhs)
+  {
+    auto const m = _lhs.size();
+
+    if (m == 0)
+    {
+      return _rhs.size();
+    }
+
+    assert(m <= 64);
+
+    // bit masks of the positions of each character in 'lhs'
+    std::array<std::uint64_t, 256> peq {};
+
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      peq[lower(_lhs[i])] |= std::uint64_t {1} << i;
+    }
+
+    std::uint64_t const last {std::uint64_t {1} << (m - 1)};
+    std::uint64_t pv {~std::uint64_t {0}};
+    std::uint64_t mv {0};
+    std::size_t score {m};
+
+    for (auto const c : _rhs)
+    {
+      auto const eq = peq[lower(c)];
+      auto const xv = eq | mv;
+      auto const xh = (((eq & pv) + pv) ^ pv) | eq;
+      auto ph = mv | ~(xh | pv);
+      auto mh = pv & xh;
+
+      if (ph & last)
+      {
+        ++score;
+      }
+      else if (mh & last)
+      {
+        --score;
+      }
+
+      ph = (ph << 1) | 1;
+      mh <<= 1;
+      pv = mh | ~(xv | ph);
+      mv = ph & xv;
+    }
+
+    return score;
+  }
+
   Parg()
   {
   }
 
   Parg(int _argc, char** _argv)
   {
-    argc_ = _argc;
-    argvf(_argv);
+    argvf(_argc, _argv);
   }
 
-  Parg& name(std::string const _name)
+  Parg& name(std::string_view const _name)
   {
     name_ = _name;
     return *this;
   }
 
-  std::string name() const
+  std::string_view name() const
   {
     return name_;
   }
 
-  Parg& version(std::string const _version)
+  Parg& version(std::string_view const _version)
   {
     version_ = _version;
     return *this;
   }
 
-  std::string version() const
+  std::string_view version() const
   {
     return version_;
   }
 
-  Parg& usage(std::string const _usage)
+  Parg& usage(std::string_view const _usage)
   {
-    usage_ += "  " + name_ + " " + _usage + "\n";
+    assert(usage_size_ < usage_.size());
+    if (usage_size_ < usage_.size())
+    {
+      usage_[usage_size_++] = _usage;
+    }
     return *this;
   }
 
-  std::string usage() const
-  {
-    return usage_;
-  }
-
-  Parg& description(std::string const _description)
+  Parg& description(std::string_view const _description)
   {
     description_ = _description;
     return *this;
   }
 
-  std::string description() const
+  std::string_view description() const
   {
     return description_;
   }
 
-  Parg& info(std::string const _title, std::vector<std::string> const _text)
+  // 'text' must outlive the parser, use an array with static storage duration
+  template<std::size_t N>
+  Parg& info(std::string_view const _title, std::string_view const (&_text)[N])
   {
-    info_.emplace_back(info_pair{_title, _text});
+    assert(info_size_ < info_.size());
+    if (info_size_ < info_.size())
+    {
+      info_[info_size_++] = {_title, _text, N};
+    }
     return *this;
   }
 
-  Parg& author(std::string const _author)
+  Parg& author(std::string_view const _author)
   {
     author_ = _author;
     return *this;
   }
 
-  std::string author() const
+  std::string_view author() const
   {
     return author_;
   }
 
+  // set the flags and options, the table must outlive the parser
+  template<std::size_t N>
+  Parg& set(Table<N> const& _table)
+  {
+    return set(_table.index());
+  }
+
+  Parg& set(Index const _index)
+  {
+    assert(_index.size <= max_options);
+    index_ = _index;
+
+    for (std::size_t i = 0; i < index_.size; ++i)
+    {
+      values_[i] = {index_.data[i].value_, false};
+    }
+
+    return *this;
+  }
+
   std::string help() const
   {
     std::stringstream out;
     if (! description_.empty())
     {
       out << name_ << ":" << "\n";
-      std::stringstream ss;
       out << "  " << description_ << "\n";
-      out << ss.str() << "\n";
+      out << "\n";
+    }
+
+    if (usage_size_)
+    {
+      out << "Usage: " << "\n";
+      for (std::size_t i = 0; i < usage_size_; ++i)
+      {
+        out << "  " << name_ << " " << usage_[i] << "\n";
+      }
+      out << "\n";
     }
 
-    if (! usage_.empty())
+    // help text for flags and options is formatted on demand
+    // to keep it out of the common parse path
+    std::string modes;
+    std::string options;
+
+    for (std::size_t i = 0; i < index_.size; ++i)
     {
-      out << "Usage: " << "\n"
-        << usage_ << "\n";
+      auto const& opt = index_.data[i];
+      (opt.mode_ ? modes : options) += help_entry(opt);
     }
 
-    if (! modes_.empty())
+    if (! modes.empty())
     {
       out << "Flags: " << "\n"
-        << modes_;
+        << modes;
     }
 
-    if (! options_.empty())
+    if (! options.empty())
     {
       out << "\nOptions: " << "\n"
-        << options_;
+        << options;
     }
 
-    if (! info_.empty())
+    for (std::size_t i = 0; i < info_size_; ++i)
     {
-      for (auto const& e : info_)
-      {
-        out << "\n" << e.title << ":" << "\n";
+      auto const& e = info_[i];
+      out << "\n" << e.title << ":" << "\n";
 
-        for (auto const& t : e.text)
-        {
-          out << "  " << t << "\n";
-        }
+      for (std::size_t j = 0; j < e.size; ++j)
+      {
+        out << "  " << e.text[j] << "\n";
       }
     }
 
     if (! author_.empty())
     {
       out << "\nAuthor: " << "\n";
-      std::stringstream ss;
-      ss << "  " << author_ << "\n";
-      out << ss.str();
+      out << "  " << author_ << "\n";
     }
 
     return out.str();
@@ -177,26 +459,24 @@ public:
     {
       pipe_stdin();
     }
-    status_ = parse_args(argc_, argv_);
+    status_ = parse_args(argc_, [this](std::size_t i) {
+      return std::string_view(argv_[i]);
+    });
     return status_;
   }
 
   int parse(int argc, char** argv)
   {
-    if (is_stdin_)
-    {
-      pipe_stdin();
-    }
-    argc_ = argc;
-    argvf(argv);
-    status_ = parse_args(argc_, argv_);
-    return status_;
+    argvf(argc, argv);
+    return parse();
   }
 
   int parse(std::string str)
   {
-    auto args = str_to_args(str);
-    status_ = parse_args(args.size(), args);
+    args_ = str_to_args(str);
+    status_ = parse_args(static_cast<int>(args_.size()), [this](std::size_t i) {
+      return std::string_view(args_[i]);
+    });
     return status_;
   }
 
@@ -292,148 +572,52 @@ public:
     return args;
   }
 
-  void set(std::string _name, std::string _info)
-  {
-    // sets a flag
-    std::string delim {","};
-    if (_name.find(delim) != std::string::npos)
-    {
-      // short and long
-      bool has_short {false};
-      std::string _long;
-      std::string _short;
-
-      auto const names = delimit(_name, delim);
-      assert(names.size() >= 1 && names.size() <= 2);
-      _long = names.at(0);
 
-      if (names.size() == 2) has_short = true;
-      if (has_short)
-      {
-        // short name must be one char
-        assert(names.at(1).size() == 1);
-        _short = names.at(1);
-      }
+  template<class T>
+  T get(std::string_view const _key) const
+  {
+    static_assert(! std::is_same_v<T, std::string>, "use non-template version of function for 'std::string' type");
+    auto const str = value(_key);
 
-      flags_[_short] = _long;
-      data_[_long].long_ = _long;
-      data_[_long].short_ = _short;
-      data_[_long].mode_ = true;
-      data_[_long].value_ = "0";
-      modes_.append("  -" + _short + ", --" + _long + "\n");
-    }
-    else
+    if constexpr (std::is_same_v<T, bool>)
     {
-      if (_name.size() == 1)
-      {
-        // short
-        flags_[_name] = _name;
-        data_[_name].long_ = _name;
-        data_[_name].short_ = _name;
-        data_[_name].mode_ = true;
-        data_[_name].value_ = "0";
-        modes_.append("  -" + _name + "\n");
-      }
-      else
-      {
-        // long
-        data_[_name].long_ = _name;
-        data_[_name].mode_ = true;
-        data_[_name].value_ = "0";
-        modes_.append("  --" + _name + "\n");
-      }
+      return str == "1";
     }
-
-    std::stringstream out;
-    out << "    " << _info << "\n";
-    modes_.append(out.str());
-  }
-
-  void set(std::string _name, std::string _default, std::string _arg, std::string _info)
-  {
-    // sets an option
-    std::string delim {","};
-    if (_name.find(delim) != std::string::npos)
+    else if constexpr (std::is_arithmetic_v<T>)
     {
-      bool has_short {false};
-      std::string _long;
-      std::string _short;
-
-      auto const names = delimit(_name, delim);
-      assert(names.size() >= 1 && names.size() <= 2);
-      _long = names.at(0);
+      // the whole value must convert
+      T val {};
+      auto const end = str.data() + str.size();
+      auto const [ptr, ec] = std::from_chars(str.data(), end, val);
 
-      if (names.size() == 2) has_short = true;
-      if (has_short)
+      if (ec != std::errc() || ptr != end)
       {
-        // short name must be one char
-        assert(names.at(1).size() == 1);
-        _short = names.at(1);
+        throw std::runtime_error("option '--" + std::string(_key) + "' expects a number, got '" + std::string(str) + "'");
       }
 
-      flags_[_short] = _long;
-      data_[_long].long_ = _long;
-      data_[_long].short_ = _short;
-      data_[_long].mode_ = false;
-      data_[_long].value_ = _default;
-      options_.append("  -" + _short + ", --" + _long + "=<" + _arg + ">\n");
+      return val;
     }
     else
     {
-      if (_name.size() == 1)
-      {
-        // short
-        flags_[_name] = _name;
-        data_[_name].long_ = _name;
-        data_[_name].short_ = _name;
-        data_[_name].mode_ = false;
-        data_[_name].value_ = _default;
-        options_.append("  -" + _name + "=<" + _arg + ">\n");
-      }
-      else
-      {
-        // long
-        data_[_name].long_ = _name;
-        data_[_name].mode_ = false;
-        data_[_name].value_ = _default;
-        options_.append("  --" + _name + "=<" + _arg + ">\n");
-      }
+      std::stringstream ss;
+      ss << str;
+      T val;
+      ss >> val;
+      return val;
     }
-
-    std::stringstream out;
-    out << "    " << _info << "\n";
-    options_.append(out.str());
   }
 
-  template<class T>
-  T get(std::string const _key)
+  std::string get(std::string_view const _key) const
   {
-    static_assert(! std::is_same_v<T, std::string>, "use non-template version of function for 'std::string' type");
-    if (data_.find(_key) == data_.end())
-    {
-      throw std::logic_error("parg get '" + _key + "' is not defined");
-    }
-    std::stringstream ss;
-    ss << data_[_key].value_;
-    T val;
-    ss >> val;
-    return val;
+    return std::string(value(_key));
   }
 
-  std::string get(std::string const _key)
-  {
-    if (data_.find(_key) == data_.end())
-    {
-      throw std::logic_error("parg get '" + _key + "' is not defined");
-    }
-    return data_[_key].value_;
-  }
-
-  bool find(std::string const _key) const
+  bool find(std::string_view const _key) const
   {
     // key must exist
-    if (data_.find(_key) == data_.end()) return false;
-    return data_.at(_key).seen_;
+    auto const i = find_long(_key);
+    if (i == none) return false;
+    return values_[i].seen_;
   }
 
   Parg& set_pos(bool const _positional = true)
@@ -492,9 +676,9 @@ public:
   {
     std::size_t count {0};
 
-    for (auto const& e : data_)
+    for (std::size_t i = 0; i < index_.size; ++i)
     {
-      if (e.second.mode_ && e.second.seen_)
+      if (index_.data[i].mode_ && values_[i].seen_)
       {
         ++count;
       }
@@ -507,9 +691,9 @@ public:
   {
     std::size_t count {0};
 
-    for (auto const& e : data_)
+    for (std::size_t i = 0; i < index_.size; ++i)
     {
-      if (! e.second.mode_ && e.second.seen_)
+      if (! index_.data[i].mode_ && values_[i].seen_)
       {
         ++count;
       }
@@ -518,37 +702,36 @@ public:
     return count;
   }
 
-  struct Option
+private:
+
+  struct Value
   {
-    std::string short_;
-    std::string long_;
-    bool mode_;
-    std::string value_;
+    // current value, refers to argv, the table, or 'args_'
+    std::string_view value_ {};
     bool seen_ {false};
-  };
+  }; // struct Value
 
-  struct info_pair
+  struct Info
   {
-    std::string title;
-    std::vector<std::string> text;
-  };
+    std::string_view title {};
+    std::string_view const* text {nullptr};
+    std::size_t size {0};
+  }; // struct Info
 
-private:
   int argc_ {0};
-  std::vector<std::string> argv_;
-  std::string name_;
-  std::string version_;
-  std::string usage_;
-  std::string description_;
-  std::string modes_;
-  std::string options_;
-  int options_indent_ {0};
-  std::vector<info_pair> info_;
-  std::string author_;
-  std::map<std::string, Option> data_;
-  std::map<std::string, std::string> flags_;
+  char** argv_ {nullptr};
+  std::vector<std::string> args_;
+  std::string_view name_;
+  std::string_view version_;
+  std::array<std::string_view, 8> usage_ {};
+  std::size_t usage_size_ {0};
+  std::string_view description_;
+  std::array<Info, 8> info_ {};
+  std::size_t info_size_ {0};
+  std::string_view author_;
+  Index index_ {};
+  std::array<Value, max_options> values_ {};
   bool is_positional_ {false};
-  std::string positional_;
   std::vector<std::string> positional_vec_;
   std::string stdin_;
   bool is_stdin_ {false};
@@ -556,16 +739,125 @@ private:
   std::string error_;
   std::vector<std::string> similar_;
 
-  void argvf(char** _argv)
+  static constexpr Option names(std::string_view const _name)
   {
-    // removes first arg
-    if (argc_ < 1) return;
-    for (int i = 1; i < argc_; ++i)
+    Option opt;
+
+    if (auto const delim = _name.find(','); delim != std::string_view::npos)
+    {
+      // short name must be one char
+      if (_name.size() != delim + 2)
+      {
+        throw std::logic_error("parg short name must be one char");
+      }
+
+      opt.long_ = _name.substr(0, delim);
+      opt.short_ = _name.back();
+    }
+    else if (_name.size() == 1)
     {
-      argv_.emplace_back(_argv[i]);
+      // short only
+      opt.long_ = _name;
+      opt.short_ = _name.front();
     }
-    // std::cerr << "argv: " << i << " -> " << argv_.at(i) << std::endl;
-    --argc_;
+    else
+    {
+      // long only
+      opt.long_ = _name;
+    }
+
+    return opt;
+  }
+
+  static unsigned char lower(char const _c)
+  {
+    auto const c = static_cast<unsigned char>(_c);
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+  }
+
+  std::uint8_t find_long(std::string_view const _name) const
+  {
+    if (! index_.data)
+    {
+      return none;
+    }
+
+    auto const i = index_.longs[hash(_name, index_.seed) & index_.mask];
+
+    if (i == none || index_.data[i].long_ != _name)
+    {
+      return none;
+    }
+
+    return i;
+  }
+
+  std::uint8_t find_short(char const _name) const
+  {
+    auto const c = static_cast<unsigned char>(_name);
+
+    if (! index_.data || c >= 128)
+    {
+      return none;
+    }
+
+    return index_.shorts[c];
+  }
+
+  std::string_view value(std::string_view const _key) const
+  {
+    auto const i = find_long(_key);
+
+    if (i == none)
+    {
+      throw std::logic_error("parg get '" + std::string(_key) + "' is not defined");
+    }
+
+    return values_[i].value_;
+  }
+
+  std::string help_entry(Option const& _opt) const
+  {
+    std::string str {"  "};
+
+    if (_opt.short_ == '\0')
+    {
+      str += "--";
+      str += _opt.long_;
+    }
+    else if (_opt.long_.size() == 1)
+    {
+      str += "-";
+      str += _opt.short_;
+    }
+    else
+    {
+      str += "-";
+      str += _opt.short_;
+      str += ", --";
+      str += _opt.long_;
+    }
+
+    if (! _opt.mode_)
+    {
+      str += "=<";
+      str += _opt.arg_;
+      str += ">";
+    }
+
+    str += "\n    ";
+    str += _opt.info_;
+    str += "\n";
+
+    return str;
+  }
+
+  void argvf(int _argc, char** _argv)
+  {
+    // removes first arg
+    if (_argc < 1) return;
+    argc_ = _argc - 1;
+    argv_ = _argv + 1;
   }
 
   int pipe_stdin()
@@ -580,21 +872,9 @@ private:
     return -1;
   }
 
-  std::vector<std::string> delimit(const std::string str, const std::string delim) const
-  {
-    std::vector<std::string> vtok;
-    std::size_t start {0};
-    std::size_t end = str.find(delim);
-    while (end != std::string::npos) {
-      vtok.emplace_back(str.substr(start, end - start));
-      start = end + delim.length();
-      end = str.find(delim, start);
-    }
-    vtok.emplace_back(str.substr(start, end));
-    return vtok;
-  }
-
-  int parse_args(int _argc, std::vector<std::string> _argv)
+  // 'argv' returns the arg at a given position as a string_view
+  template<typename F>
+  int parse_args(int _argc, F const& _argv)
   {
     if (_argc < 1) return 1;
 
@@ -603,8 +883,7 @@ private:
     // loop through arg vector
     for (int i = 0; i < _argc; ++i)
     {
-      std::string const& tmp {_argv.at(static_cast<std::size_t>(i))};
-      // std::cerr << "ARG: " << i << " -> " << tmp << std::endl;
+      std::string_view const tmp {_argv(static_cast<std::size_t>(i))};
 
       if (dashdash)
       {
@@ -615,41 +894,34 @@ private:
       if (tmp.size() > 1 && tmp.at(0) == '-' && tmp.at(1) != '-')
       {
         // short
-        // std::cerr << "SHORT: " << tmp << std::endl;
+        auto const c = find_short(tmp.at(1));
 
-        std::string c {tmp.at(1)};
-        if (flags_.find(c) != flags_.end() && !(data_.at(flags_.at(c)).mode_))
+        if (c != none && ! index_.data[c].mode_)
         {
           // short arg
-          // std::cerr << "SHORT: arg -> " << c << std::endl;
-
-          if (data_.at(flags_.at(c)).seen_)
+          if (values_[c].seen_)
           {
             // error
-            error_ = "flag '-" + c + "' has already been seen";
+            error_ = "flag '-" + std::string(tmp.substr(1, 1)) + "' has already been seen";
             return -1;
           }
 
           if (tmp.size() > 2 && tmp.at(2) != '=')
           {
-            data_.at(flags_.at(c)).value_ = tmp.substr(2, tmp.size() - 1);
-            data_.at(flags_.at(c)).seen_ = true;
+            values_[c] = {tmp.substr(2), true};
           }
           else if (tmp.size() > 3 && tmp.at(2) == '=')
           {
-            data_.at(flags_.at(c)).value_ = tmp.substr(3, tmp.size() - 1);
-            data_.at(flags_.at(c)).seen_ = true;
+            values_[c] = {tmp.substr(3), true};
           }
           else if (i + 1 < _argc)
           {
-            data_.at(flags_.at(c)).value_ = _argv.at(static_cast<std::size_t>(i + 1));
-            data_.at(flags_.at(c)).seen_ = true;
-            ++i;
+            values_[c] = {_argv(static_cast<std::size_t>(++i)), true};
           }
           else
           {
             // error
-            error_ = "flag '-" + c + "' requires an arg";
+            error_ = "flag '-" + std::string(tmp.substr(1, 1)) + "' requires an arg";
             return -1;
           }
         }
@@ -658,27 +930,24 @@ private:
           // short mode
           for (std::size_t j = 1; j < tmp.size(); ++j)
           {
-            std::string s {tmp.at(j)};
+            auto const s = find_short(tmp.at(j));
 
-            if (flags_.find(s) != flags_.end() && data_.at(flags_.at(s)).mode_)
+            if (s != none && index_.data[s].mode_)
             {
-              // std::cerr << "SHORT: mode -> " << s << std::endl;
-
-              if (data_.at(flags_.at(s)).seen_)
+              if (values_[s].seen_)
               {
                 // error
-                error_ = "flag '-" + s + "' has already been seen";
+                error_ = "flag '-" + std::string(tmp.substr(j, 1)) + "' has already been seen";
                 return -1;
               }
 
-              data_.at(flags_.at(s)).value_ = "1";
-              data_.at(flags_.at(s)).seen_ = true;
+              values_[s] = {"1", true};
             }
             else
             {
               // error
-              error_ = "invalid flag '" + tmp + "'";
-              find_similar(s);
+              error_ = "invalid flag '" + std::string(tmp) + "'";
+              find_similar(tmp.substr(j, 1));
 
               return -1;
             }
@@ -688,50 +957,44 @@ private:
       else if (tmp.size() > 2 && tmp.at(0) == '-' && tmp.at(1) == '-')
       {
         // long || --
-        // std::cerr << "LONG: " << tmp << std::endl;
-        std::string c {tmp.substr(2, tmp.size() - 1)};
-        std::string a;
+        auto c = tmp.substr(2);
+        std::string_view a;
 
-        auto const delim = c.find("=");
-        if (delim != std::string::npos)
+        if (auto const delim = c.find('='); delim != std::string_view::npos)
         {
-          c = tmp.substr(2, delim);
-          a = tmp.substr(3 + delim, tmp.size() - 1);
+          a = c.substr(delim + 1);
+          c = c.substr(0, delim);
         }
 
-        if (data_.find(c) != data_.end())
+        auto const k = find_long(c);
+
+        if (k != none)
         {
-          if (data_.at(c).seen_)
+          if (values_[k].seen_)
           {
             // error
-            error_ = "option '--" + c + "' has already been seen";
+            error_ = "option '--" + std::string(c) + "' has already been seen";
             return -1;
           }
 
-          if (data_.at(c).mode_ && a.size() == 0)
+          if (index_.data[k].mode_ && a.size() == 0)
           {
-            // std::cerr << "LONG: mode -> " << c << std::endl;
-            data_.at(c).value_ = "1";
-            data_.at(c).seen_ = true;
+            values_[k] = {"1", true};
           }
           else
           {
-            // std::cerr << "LONG: arg -> " << c << std::endl;
             if (a.size() > 0)
             {
-              data_.at(c).value_ = a;
-              data_.at(c).seen_ = true;
+              values_[k] = {a, true};
             }
             else if (i + 1 < _argc)
             {
-              data_.at(c).value_ = _argv.at(static_cast<std::size_t>(i + 1));
-              data_.at(c).seen_ = true;
-              ++i;
+              values_[k] = {_argv(static_cast<std::size_t>(++i)), true};
             }
             else
             {
               // error
-              error_ = "option '--" + c + "' requires an arg";
+              error_ = "option '--" + std::string(c) + "' requires an arg";
               return -1;
             }
           }
@@ -739,7 +1002,7 @@ private:
         else
         {
           // error
-          error_ = "invalid option '" + tmp + "'";
+          error_ = "invalid option '" + std::string(tmp) + "'";
           find_similar(c);
           return -1;
         }
@@ -747,7 +1010,6 @@ private:
       else if (tmp.size() > 0 && is_positional_)
       {
         // positional
-        // std::cerr << "POS: " << tmp << std::endl;
         if (tmp == "--")
         {
           dashdash = true;
@@ -760,7 +1022,7 @@ private:
       else
       {
         // error
-        error_ = "no match for '" + tmp + "'";
+        error_ = "no match for '" + std::string(tmp) + "'";
         find_similar(tmp);
         return -1;
       }
@@ -769,44 +1031,43 @@ private:
     return 0;
   }
 
-  void find_similar(std::string const& name)
+  void find_similar(std::string_view const _name)
   {
-    std::stringstream escaped_name;
+    similar_.clear();
 
-    for (auto const& e : name)
+    // rank long names by edit distance, treating abbreviations as close
+    std::array<std::pair<std::size_t, std::uint8_t>, max_options> rank {};
+    std::size_t size {0};
+    std::size_t const limit {std::max<std::size_t>(2, _name.size() / 3)};
+
+    for (std::size_t i = 0; i < index_.size; ++i)
     {
-      if (std::isalnum(e))
+      auto const& opt = index_.data[i].long_;
+      auto dist = distance(opt, _name);
+
+      if (opt.size() > _name.size() && distance(opt.substr(0, _name.size()), _name) == 0)
       {
-        escaped_name << e;
+        dist = std::min<std::size_t>(dist, 1);
       }
-      else
+
+      if (dist <= limit)
       {
-        escaped_name << "\\" << e;
+        rank[size++] = {dist, static_cast<std::uint8_t>(i)};
       }
     }
 
-    int len = (name.size() / 1.2);
-
-    std::string similar_regex {"^.*[" + escaped_name.str() + "]{" + std::to_string(len) + "}.*$"};
-
-    std::smatch match;
-
-    for (auto const& e : data_)
-    {
-      if (std::regex_match(e.second.long_, match, std::regex(similar_regex, std::regex::icase), std::regex_constants::match_not_null))
+    std::stable_sort(rank.begin(), rank.begin() + static_cast<std::ptrdiff_t>(size),
+    [&](auto const& lhs, auto const& rhs) {
+      if (lhs.first != rhs.first)
       {
-        similar_.emplace_back("--" + std::string(match[0]));
+        return lhs.first < rhs.first;
       }
-    }
-
-    std::sort(similar_.begin(), similar_.end(),
-    [](std::string const& lhs, std::string const& rhs) {
-      return lhs.size() < rhs.size();
+      return index_.data[lhs.second].long_.size() < index_.data[rhs.second].long_.size();
     });
 
-    if (similar_.size() > 8)
+    for (std::size_t i = 0; i < size && i < 8; ++i)
     {
-      similar_.erase(similar_.begin() + 8, similar_.end());
+      similar_.emplace_back("--" + std::string(index_.data[rank[i].second].long_));
     }
   }
 }; // class Parg
@@ -0,0 +1,79 @@
+#ifndef OB_RING_HH
+#define OB_RING_HH
+
+#include <cstddef>
+
+#include <array>
+#include <atomic>
+
+namespace OB
+{
+
+// a fixed ring of slots handed from one producer thread to one consumer thread without locks
+// slots are filled and drained in place and reused, so the storage they hold is kept between uses
+template<typename T, std::size_t N>
+class Ring
+{
+  static_assert(N && (N & (N - 1)) == 0, "ring size must be a power of two");
+
+public:
+
+  Ring() = default;
+
+  Ring(Ring const&) = delete;
+  Ring& operator=(Ring const&) = delete;
+
+  // the slot to fill next, or nullptr if the ring is full
+  // producer only
+  T* back()
+  {
+    auto const tail = _tail.load(std::memory_order_relaxed);
+
+    if (tail - _head.load(std::memory_order_acquire) == N)
+    {
+      return nullptr;
+    }
+
+    return &_slots[tail & (N - 1)];
+  }
+
+  // hand the slot from 'back' to the consumer
+  // producer only
+  void push()
+  {
+    _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // the slot to drain next, or nullptr if the ring is empty
+  // consumer only
+  T* front()
+  {
+    auto const head = _head.load(std::memory_order_relaxed);
+
+    if (head == _tail.load(std::memory_order_acquire))
+    {
+      return nullptr;
+    }
+
+    return &_slots[head & (N - 1)];
+  }
+
+  // hand the slot from 'front' back to the producer
+  // consumer only
+  void pop()
+  {
+    _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+private:
+
+  std::array<T, N> _slots {};
+
+  // kept on separate cache lines so the threads do not contend
+  alignas(64) std::atomic<std::size_t> _head {0};
+  alignas(64) std::atomic<std::size_t> _tail {0};
+}; // class Ring
+
+} // namespace OB
+
+#endif // OB_RING_HH
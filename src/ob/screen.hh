@@ -0,0 +1,839 @@
+#ifndef OB_SCREEN_HH
+#define OB_SCREEN_HH
+
+#include "ob/writer.hh"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+namespace OB::Term
+{
+
+struct Color
+{
+  enum Kind : std::uint8_t
+  {
+    none,
+    basic,
+    rgb,
+  };
+
+  Kind kind {none};
+  std::uint8_t r {0};
+  std::uint8_t g {0};
+  std::uint8_t b {0};
+
+  // one of the 8 standard colors, black, red, green, yellow, blue, magenta, cyan, white
+  static constexpr Color index(std::uint8_t n_)
+  {
+    return Color {basic, n_, 0, 0};
+  }
+
+  static constexpr Color true_color(std::uint8_t r_, std::uint8_t g_, std::uint8_t b_)
+  {
+    return Color {rgb, r_, g_, b_};
+  }
+
+  // parse '#rgb' or '#rrggbb', the '#' is optional
+  // returns the default color if 'str_' is invalid
+  static Color hex(std::string_view str_)
+  {
+    if (! str_.empty() && str_.front() == '#')
+    {
+      str_.remove_prefix(1);
+    }
+
+    if (str_.size() != 3 && str_.size() != 6)
+    {
+      return {};
+    }
+
+    std::array<std::uint8_t, 6> digits {};
+
+    for (std::size_t i = 0; i < str_.size(); ++i)
+    {
+      auto const c = str_.at(i);
+
+      if (c >= '0' && c <= '9')
+      {
+        digits.at(i) = static_cast<std::uint8_t>(c - '0');
+      }
+      else if (c >= 'a' && c <= 'f')
+      {
+        digits.at(i) = static_cast<std::uint8_t>(c - 'a' + 10);
+      }
+      else if (c >= 'A' && c <= 'F')
+      {
+        digits.at(i) = static_cast<std::uint8_t>(c - 'A' + 10);
+      }
+      else
+      {
+        return {};
+      }
+    }
+
+    if (str_.size() == 3)
+    {
+      return true_color(
+        static_cast<std::uint8_t>(digits.at(0) * 17),
+        static_cast<std::uint8_t>(digits.at(1) * 17),
+        static_cast<std::uint8_t>(digits.at(2) * 17));
+    }
+
+    return true_color(
+      static_cast<std::uint8_t>(digits.at(0) * 16 + digits.at(1)),
+      static_cast<std::uint8_t>(digits.at(2) * 16 + digits.at(3)),
+      static_cast<std::uint8_t>(digits.at(4) * 16 + digits.at(5)));
+  }
+
+  friend bool operator==(Color const& lhs_, Color const& rhs_)
+  {
+    return lhs_.kind == rhs_.kind && lhs_.r == rhs_.r && lhs_.g == rhs_.g && lhs_.b == rhs_.b;
+  }
+
+  friend bool operator!=(Color const& lhs_, Color const& rhs_)
+  {
+    return ! (lhs_ == rhs_);
+  }
+}; // struct Color
+
+struct Style
+{
+  enum Attr : std::uint8_t
+  {
+    bold = 1 << 0,
+    dim = 1 << 1,
+    italic = 1 << 2,
+    underline = 1 << 3,
+    blink = 1 << 4,
+    reverse = 1 << 5,
+    strike = 1 << 6,
+  };
+
+  Color fg {};
+  Color bg {};
+  std::uint8_t attr {0};
+
+  friend bool operator==(Style const& lhs_, Style const& rhs_)
+  {
+    return lhs_.fg == rhs_.fg && lhs_.bg == rhs_.bg && lhs_.attr == rhs_.attr;
+  }
+
+  friend bool operator!=(Style const& lhs_, Style const& rhs_)
+  {
+    return ! (lhs_ == rhs_);
+  }
+}; // struct Style
+
+// a double buffered grid of styled cells
+// text is drawn into the back buffer, and flush writes the escape codes that turn
+// the previous frame into the new one, so the bytes written are proportional to what changed
+// a wide code point, such as a cjk ideograph or an emoji, takes up two cells,
+// a lead cell holding it and a continuation cell after it, combining marks and
+// other zero width code points are dropped, everything else takes up one cell
+class Screen
+{
+public:
+
+  explicit Screen(int fd_) :
+    _fd {fd_}
+  {
+  }
+
+  std::size_t width() const
+  {
+    return _width;
+  }
+
+  std::size_t height() const
+  {
+    return _height;
+  }
+
+  // a new size clears the back buffer and redraws everything on the next flush
+  void size(std::size_t width_, std::size_t height_)
+  {
+    if (width_ == _width && height_ == _height)
+    {
+      return;
+    }
+
+    _width = width_;
+    _height = height_;
+    _back.assign(_width * _height, Cell {});
+    _front.assign(_width * _height, Cell {});
+    _full = true;
+  }
+
+  // blank the back buffer
+  void clear()
+  {
+    std::fill(_back.begin(), _back.end(), Cell {});
+  }
+
+  // draw 'str_' from column 'x_' of row 'y_', returns the number of cells used
+  // text past the right edge is dropped, control characters are drawn as spaces,
+  // tabs advance to the next multiple of 'tab_width' from 'x_', and a wide
+  // code point that does not fit before the edge is drawn as a space
+  std::size_t put(std::size_t x_, std::size_t y_, std::string_view str_, Style const& style_ = {})
+  {
+    if (y_ >= _height || x_ >= _width)
+    {
+      return 0;
+    }
+
+    auto* const row = &_back.at(y_ * _width);
+    auto x = x_;
+
+    for (std::size_t i = 0; i < str_.size() && x < _width;)
+    {
+      auto const c = static_cast<unsigned char>(str_.at(i));
+
+      if (c == '\t')
+      {
+        auto const end = std::min(x + tab_width - (x - x_) % tab_width, _width);
+
+        for (; x < end; ++x)
+        {
+          set(row, x, Cell {{{' '}}, 1, style_});
+        }
+
+        ++i;
+
+        continue;
+      }
+
+      std::size_t len {1};
+
+      if (c >= 0xf0)
+      {
+        len = 4;
+      }
+      else if (c >= 0xe0)
+      {
+        len = 3;
+      }
+      else if (c >= 0xc0)
+      {
+        len = 2;
+      }
+
+      len = std::min(len, str_.size() - i);
+
+      if (c < 0x20 || c == 0x7f)
+      {
+        set(row, x++, Cell {{{' '}}, 1, style_});
+        i += len;
+
+        continue;
+      }
+
+      auto const cols = columns(decode(str_.substr(i, len)));
+
+      if (cols == 0)
+      {
+        i += len;
+
+        continue;
+      }
+
+      if (cols == 2 && x + 1 == _width)
+      {
+        set(row, x++, Cell {{{' '}}, 1, style_});
+
+        break;
+      }
+
+      Cell cell {{}, static_cast<std::uint8_t>(len), style_};
+      std::copy_n(str_.data() + i, len, cell.ch.begin());
+      set(row, x++, cell);
+
+      if (cols == 2)
+      {
+        set(row, x++, Cell {{{' '}}, 0, style_});
+      }
+
+      i += len;
+    }
+
+    return x - x_;
+  }
+
+  // draw 'str_' like put, starting in 'style_' and switching style at each
+  // select graphic rendition code in it, other escape sequences are dropped
+  // returns the number of cells used
+  std::size_t put_sgr(std::size_t x_, std::size_t y_, std::string_view str_, Style style_)
+  {
+    auto x = x_;
+
+    while (! str_.empty())
+    {
+      auto const pos = std::min(str_.find('\x1b'), str_.size());
+      x += put(x, y_, str_.substr(0, pos), style_);
+      str_.remove_prefix(pos);
+
+      if (! str_.empty())
+      {
+        auto const len = escape(str_, style_);
+        str_.remove_prefix(len);
+      }
+    }
+
+    return x - x_;
+  }
+
+  // apply the select graphic rendition codes in 'str_' to 'style_' in order,
+  // leaving it as the style in effect at the end of the text
+  static void sgr(std::string_view str_, Style& style_)
+  {
+    for (auto pos = str_.find('\x1b'); pos != std::string_view::npos; pos = str_.find('\x1b'))
+    {
+      str_.remove_prefix(pos);
+      str_.remove_prefix(escape(str_, style_));
+    }
+  }
+
+  // set 'n_' cells from column 'x_' of row 'y_' to blanks in 'style_'
+  void fill(std::size_t x_, std::size_t y_, std::size_t n_, Style const& style_ = {})
+  {
+    if (y_ >= _height || x_ >= _width)
+    {
+      return;
+    }
+
+    auto* const row = &_back.at(y_ * _width);
+
+    for (auto x = x_; x < std::min(x_ + n_, _width); ++x)
+    {
+      set(row, x, Cell {{{' '}}, 1, style_});
+    }
+  }
+
+  // assume nothing about what is on the terminal, the next flush redraws everything
+  void redraw()
+  {
+    _full = true;
+  }
+
+  // write the difference between the last frame and the back buffer in one write
+  // returns false on a write error
+  bool flush()
+  {
+    _out.clear();
+
+    if (_full)
+    {
+      // start from a blank screen so only the cells that are not blank get written
+      _out += "\x1b[0m\x1b[2J";
+      std::fill(_front.begin(), _front.end(), Cell {});
+      _pen = Style {};
+      _pen_known = true;
+      _cursor_known = false;
+      _full = false;
+    }
+
+    Cell const blank {};
+
+    for (std::size_t y = 0; y < _height; ++y)
+    {
+      auto const* const back = &_back.at(y * _width);
+      auto* const front = &_front.at(y * _width);
+
+      // the blank cells at the end of the row are erased with a single code
+      auto end = _width;
+
+      while (end && back[end - 1] == blank)
+      {
+        --end;
+      }
+
+      for (std::size_t x = 0; x < end; ++x)
+      {
+        // a continuation cell is written with its lead cell
+        if (back[x] == front[x] || back[x].len == 0)
+        {
+          continue;
+        }
+
+        move(x, y, back);
+        pen(back[x].style);
+        _out.append(back[x].ch.data(), back[x].len);
+
+        // the cursor advances past both cells of a wide code point
+        _x += x + 1 < _width && back[x + 1].len == 0 ? 2 : 1;
+
+        // the cursor position after the last column depends on the terminal
+        if (_x == _width)
+        {
+          _cursor_known = false;
+        }
+      }
+
+      if (std::any_of(front + end, front + _width, [&](Cell const& e) { return e != blank; }))
+      {
+        move(end, y, back);
+        pen(Style {});
+        _out += "\x1b[K";
+      }
+
+      std::copy(back, back + _width, front);
+    }
+
+    OB::Writer writer {_fd};
+    writer.ref(_out);
+
+    return writer.flush();
+  }
+
+private:
+
+  struct Cell
+  {
+    // the utf-8 encoding of the code point, a length of 0 marks the
+    // continuation cell after a wide code point
+    std::array<char, 4> ch {{' '}};
+    std::uint8_t len {1};
+    Style style {};
+
+    friend bool operator==(Cell const& lhs_, Cell const& rhs_)
+    {
+      return lhs_.len == rhs_.len && lhs_.style == rhs_.style &&
+        std::equal(lhs_.ch.begin(), lhs_.ch.begin() + lhs_.len, rhs_.ch.begin());
+    }
+
+    friend bool operator!=(Cell const& lhs_, Cell const& rhs_)
+    {
+      return ! (lhs_ == rhs_);
+    }
+  }; // struct Cell
+
+  // overwrite the cell at 'x_' of 'row_', blanking what is left
+  // of a wide code point it covers half of
+  void set(Cell* row_, std::size_t x_, Cell const& cell_)
+  {
+    if (row_[x_].len == 0 && cell_.len != 0 && x_ > 0)
+    {
+      row_[x_ - 1] = Cell {{{' '}}, 1, row_[x_ - 1].style};
+    }
+
+    if (row_[x_].len != 0 && x_ + 1 < _width && row_[x_ + 1].len == 0)
+    {
+      row_[x_ + 1] = Cell {{{' '}}, 1, row_[x_ + 1].style};
+    }
+
+    row_[x_] = cell_;
+  }
+
+  // decode the utf-8 sequence 'str_', returns U+FFFD if it is invalid
+  static char32_t decode(std::string_view str_)
+  {
+    auto const lead = static_cast<unsigned char>(str_.at(0));
+
+    if (str_.size() == 1)
+    {
+      return lead < 0x80 ? lead : 0xfffd;
+    }
+
+    char32_t cp = lead & (0x7f >> str_.size());
+
+    for (std::size_t i = 1; i < str_.size(); ++i)
+    {
+      auto const c = static_cast<unsigned char>(str_.at(i));
+
+      if ((c & 0xc0) != 0x80)
+      {
+        return 0xfffd;
+      }
+
+      cp = (cp << 6) | (c & 0x3f);
+    }
+
+    return cp;
+  }
+
+  // the number of cells the code point 'cp_' takes up on a terminal,
+  // 2 for the east asian wide and fullwidth ranges and the emoji drawn wide,
+  // 0 for combining marks and other zero width code points, otherwise 1
+  static std::size_t columns(char32_t cp_)
+  {
+    if (cp_ < 0x300)
+    {
+      return 1;
+    }
+
+    using Range = std::pair<char32_t, char32_t>;
+
+    auto const in = [&](auto const& ranges) {
+      auto const it = std::upper_bound(ranges.begin(), ranges.end(), cp_,
+        [](char32_t cp, Range const& range) { return cp < range.first; });
+
+      return it != ranges.begin() && cp_ <= std::prev(it)->second;
+    };
+
+    static std::array<Range, 11> constexpr zero {{
+      {0x0300, 0x036f}, {0x1ab0, 0x1aff}, {0x1dc0, 0x1dff}, {0x200b, 0x200f},
+      {0x2028, 0x202e}, {0x2060, 0x2064}, {0x20d0, 0x20ff}, {0xfe00, 0xfe0f},
+      {0xfe20, 0xfe2f}, {0xfeff, 0xfeff}, {0xe0100, 0xe01ef},
+    }};
+
+    static std::array<Range, 62> constexpr wide {{
+      {0x1100, 0x115f}, {0x231a, 0x231b}, {0x2329, 0x232a}, {0x23e9, 0x23ec},
+      {0x23f0, 0x23f0}, {0x23f3, 0x23f3}, {0x25fd, 0x25fe}, {0x2614, 0x2615},
+      {0x2648, 0x2653}, {0x267f, 0x267f}, {0x2693, 0x2693}, {0x26a1, 0x26a1},
+      {0x26aa, 0x26ab}, {0x26bd, 0x26be}, {0x26c4, 0x26c5}, {0x26ce, 0x26ce},
+      {0x26d4, 0x26d4}, {0x26ea, 0x26ea}, {0x26f2, 0x26f3}, {0x26f5, 0x26f5},
+      {0x26fa, 0x26fa}, {0x26fd, 0x26fd}, {0x2705, 0x2705}, {0x270a, 0x270b},
+      {0x2728, 0x2728}, {0x274c, 0x274c}, {0x274e, 0x274e}, {0x2753, 0x2755},
+      {0x2757, 0x2757}, {0x2795, 0x2797}, {0x27b0, 0x27b0}, {0x27bf, 0x27bf},
+      {0x2b1b, 0x2b1c}, {0x2b50, 0x2b50}, {0x2b55, 0x2b55}, {0x2e80, 0x303e},
+      {0x3041, 0x33ff}, {0x3400, 0x4dbf}, {0x4e00, 0x9fff}, {0xa000, 0xa4cf},
+      {0xa960, 0xa97f}, {0xac00, 0xd7a3}, {0xf900, 0xfaff}, {0xfe10, 0xfe19},
+      {0xfe30, 0xfe6f}, {0xff00, 0xff60}, {0xffe0, 0xffe6}, {0x16fe0, 0x16fe4},
+      {0x17000, 0x18cff}, {0x1b000, 0x1b2ff}, {0x1f004, 0x1f004}, {0x1f0cf, 0x1f0cf},
+      {0x1f18e, 0x1f18e}, {0x1f191, 0x1f19a}, {0x1f200, 0x1f251}, {0x1f300, 0x1f64f},
+      {0x1f680, 0x1f6ff}, {0x1f7e0, 0x1f7eb}, {0x1f90c, 0x1f9ff}, {0x1fa70, 0x1faff},
+      {0x20000, 0x2fffd}, {0x30000, 0x3fffd},
+    }};
+
+    if (in(zero))
+    {
+      return 0;
+    }
+
+    return in(wide) ? 2 : 1;
+  }
+
+  // get the length of the escape sequence at the start of 'str_',
+  // applying it to 'style_' if it is a select graphic rendition code
+  static std::size_t escape(std::string_view str_, Style& style_)
+  {
+    if (str_.size() < 2 || str_.at(1) != '[')
+    {
+      return std::min<std::size_t>(str_.size(), 2);
+    }
+
+    // the parameters end at the final byte
+    std::size_t end {2};
+
+    while (end < str_.size() && (str_.at(end) < 0x40 || str_.at(end) > 0x7e))
+    {
+      ++end;
+    }
+
+    if (end == str_.size())
+    {
+      return end;
+    }
+
+    if (str_.at(end) != 'm')
+    {
+      return end + 1;
+    }
+
+    // split the parameters, an empty one is 0
+    std::array<unsigned int, 16> params {};
+    std::size_t count {1};
+
+    for (auto i = std::size_t {2}; i < end; ++i)
+    {
+      auto const c = str_.at(i);
+
+      if (c == ';' || c == ':')
+      {
+        count = std::min(count + 1, params.size());
+      }
+      else if (c >= '0' && c <= '9')
+      {
+        auto& val = params.at(count - 1);
+        val = std::min(val * 10 + static_cast<unsigned int>(c - '0'), 1000u);
+      }
+    }
+
+    // the color after 38 or 48, as '5;n' or '2;r;g;b'
+    auto const extended = [&](std::size_t& i) -> Color {
+      if (i + 2 < count && params.at(i + 1) == 5)
+      {
+        auto const n = params.at(i + 2) % 256;
+        i += 2;
+
+        if (n < 16)
+        {
+          return Color::index(static_cast<std::uint8_t>(n % 8));
+        }
+
+        if (n >= 232)
+        {
+          auto const v = static_cast<std::uint8_t>(8 + (n - 232) * 10);
+
+          return Color::true_color(v, v, v);
+        }
+
+        auto const level = [](unsigned int v) {
+          return static_cast<std::uint8_t>(v ? 55 + v * 40 : 0);
+        };
+
+        return Color::true_color(level((n - 16) / 36), level((n - 16) / 6 % 6),
+          level((n - 16) % 6));
+      }
+
+      if (i + 4 < count && params.at(i + 1) == 2)
+      {
+        auto const rgb = Color::true_color(static_cast<std::uint8_t>(params.at(i + 2)),
+          static_cast<std::uint8_t>(params.at(i + 3)), static_cast<std::uint8_t>(params.at(i + 4)));
+        i += 4;
+
+        return rgb;
+      }
+
+      i = count;
+
+      return {};
+    };
+
+    auto const off = [&](unsigned int flags) {
+      style_.attr = static_cast<std::uint8_t>(style_.attr & ~flags);
+    };
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto const val = params.at(i);
+
+      switch (val)
+      {
+        case 0: style_ = Style {}; break;
+        case 1: style_.attr |= Style::bold; break;
+        case 2: style_.attr |= Style::dim; break;
+        case 3: style_.attr |= Style::italic; break;
+        case 4: style_.attr |= Style::underline; break;
+        case 5: style_.attr |= Style::blink; break;
+        case 7: style_.attr |= Style::reverse; break;
+        case 9: style_.attr |= Style::strike; break;
+        case 21: case 22: off(Style::bold | Style::dim); break;
+        case 23: off(Style::italic); break;
+        case 24: off(Style::underline); break;
+        case 25: off(Style::blink); break;
+        case 27: off(Style::reverse); break;
+        case 29: off(Style::strike); break;
+        case 38: style_.fg = extended(i); break;
+        case 39: style_.fg = {}; break;
+        case 48: style_.bg = extended(i); break;
+        case 49: style_.bg = {}; break;
+        default:
+        {
+          if (val >= 30 && val <= 37)
+          {
+            style_.fg = Color::index(static_cast<std::uint8_t>(val - 30));
+          }
+          else if (val >= 40 && val <= 47)
+          {
+            style_.bg = Color::index(static_cast<std::uint8_t>(val - 40));
+          }
+          else if (val >= 90 && val <= 97)
+          {
+            style_.fg = Color::index(static_cast<std::uint8_t>(val - 90));
+          }
+          else if (val >= 100 && val <= 107)
+          {
+            style_.bg = Color::index(static_cast<std::uint8_t>(val - 100));
+          }
+
+          break;
+        }
+      }
+    }
+
+    return end + 1;
+  }
+
+  // move the cursor to 'x_' of row 'y_' using the shortest sequence,
+  // which may be rewriting the cells in between
+  void move(std::size_t x_, std::size_t y_, Cell const* row_)
+  {
+    if (_cursor_known && y_ == _y)
+    {
+      if (x_ == _x)
+      {
+        return;
+      }
+
+      if (x_ > _x)
+      {
+        auto const gap = x_ - _x;
+        auto const code = "\x1b[" + std::to_string(gap) + "C";
+
+        std::size_t bytes {0};
+        bool same_pen {_pen_known};
+
+        for (auto x = _x; x < x_ && same_pen && bytes <= code.size(); ++x)
+        {
+          same_pen = row_[x].style == _pen;
+          bytes += row_[x].len;
+        }
+
+        if (same_pen && bytes <= code.size())
+        {
+          for (auto x = _x; x < x_; ++x)
+          {
+            _out.append(row_[x].ch.data(), row_[x].len);
+          }
+        }
+        else
+        {
+          _out += code;
+        }
+
+        _x = x_;
+
+        return;
+      }
+
+      if (x_ == 0)
+      {
+        _out += '\r';
+        _x = 0;
+
+        return;
+      }
+    }
+
+    if (_cursor_known && x_ == 0 && y_ == _y + 1)
+    {
+      _out += "\r\n";
+    }
+    else
+    {
+      _out += "\x1b[" + std::to_string(y_ + 1) + ";" + std::to_string(x_ + 1) + "H";
+    }
+
+    _x = x_;
+    _y = y_;
+    _cursor_known = true;
+  }
+
+  // switch the pen to 'style_' with a single select graphic rendition code
+  void pen(Style const& style_)
+  {
+    if (_pen_known && style_ == _pen)
+    {
+      return;
+    }
+
+    std::string code {"\x1b["};
+
+    auto const add = [&](std::string_view str) {
+      if (code.size() > 2)
+      {
+        code += ';';
+      }
+
+      code += str;
+    };
+
+    auto const color = [&](Color const& val, char base) {
+      switch (val.kind)
+      {
+        case Color::none:
+        {
+          add({&base, 1});
+          code += '9';
+          break;
+        }
+        case Color::basic:
+        {
+          add({&base, 1});
+          code += static_cast<char>('0' + val.r % 8);
+          break;
+        }
+        case Color::rgb:
+        {
+          add({&base, 1});
+          code += "8;2;" + std::to_string(unsigned {val.r}) + ";" +
+            std::to_string(unsigned {val.g}) + ";" + std::to_string(unsigned {val.b});
+          break;
+        }
+        default:
+        {
+          break;
+        }
+      }
+    };
+
+    // turning an attribute off resets everything, otherwise only the changes are sent
+    auto prev = _pen;
+
+    if (! _pen_known || (prev.attr & ~style_.attr))
+    {
+      add("0");
+      prev = Style {};
+    }
+
+    std::array<std::pair<std::uint8_t, char>, 7> constexpr attrs {{
+      {Style::bold, '1'},
+      {Style::dim, '2'},
+      {Style::italic, '3'},
+      {Style::underline, '4'},
+      {Style::blink, '5'},
+      {Style::reverse, '7'},
+      {Style::strike, '9'},
+    }};
+
+    for (auto const& [flag, val] : attrs)
+    {
+      if ((style_.attr & flag) && ! (prev.attr & flag))
+      {
+        add({&val, 1});
+      }
+    }
+
+    if (style_.fg != prev.fg)
+    {
+      color(style_.fg, '3');
+    }
+
+    if (style_.bg != prev.bg)
+    {
+      color(style_.bg, '4');
+    }
+
+    code += 'm';
+    _out += code;
+
+    _pen = style_;
+    _pen_known = true;
+  }
+
+  static constexpr std::size_t tab_width {4};
+
+  int _fd;
+  std::size_t _width {0};
+  std::size_t _height {0};
+
+  // the frame being drawn and the frame on the terminal
+  std::vector<Cell> _back;
+  std::vector<Cell> _front;
+
+  // redraw everything on the next flush
+  bool _full {true};
+
+  // the state of the terminal after the last write
+  Style _pen {};
+  bool _pen_known {false};
+  std::size_t _x {0};
+  std::size_t _y {0};
+  bool _cursor_known {false};
+
+  // reused between flushes
+  std::string _out;
+}; // class Screen
+
+} // namespace OB::Term
+
+#endif // OB_SCREEN_HH
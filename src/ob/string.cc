@@ -3,14 +3,28 @@
 #include <cstddef>
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <regex>
-#include <optional>
 #include <limits>
 
 namespace OB::String
 {
 
+std::string lower(std::string_view str)
+{
+  std::string res {str};
+
+  for (auto& c : res)
+  {
+    if (is(c, Class::upper))
+    {
+      c = static_cast<char>(c + ('a' - 'A'));
+    }
+  }
+
+  return res;
+}
+
 std::vector<std::string> split(std::string const& str, std::string const& delim, std::size_t times)
 {
   std::vector<std::string> vtok;
@@ -28,29 +42,4 @@ std::vector<std::string> split(std::string const& str, std::string const& delim,
   return vtok;
 }
 
-bool assert_rx(std::string str, std::regex rx)
-{
-  std::smatch m;
-  if (std::regex_match(str, m, rx, std::regex_constants::match_not_null))
-  {
-    return true;
-  }
-  return false;
-}
-
-std::optional<std::vector<std::string>> match(std::string const& str, std::regex rx)
-{
-  std::smatch m;
-  if (std::regex_match(str, m, rx, std::regex_constants::match_not_null))
-  {
-    std::vector<std::string> v;
-    for (auto const& e : m)
-    {
-      v.emplace_back(std::string(e));
-    }
-    return v;
-  }
-  return {};
-}
-
 } // namespace OB::String
@@ -2,21 +2,156 @@
 #define OB_STRING_HH
 
 #include <cstddef>
+#include <cstdint>
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <regex>
+#include <array>
 #include <optional>
 #include <limits>
+#include <initializer_list>
 
 namespace OB::String
 {
 
-std::vector<std::string> split(std::string const& str, std::string const& delim, std::size_t size = std::numeric_limits<std::size_t>::max());
+// character classes, combined as a bit mask
+namespace Class
+{
+
+std::uint8_t constexpr lower {1 << 0};
+std::uint8_t constexpr upper {1 << 1};
+std::uint8_t constexpr digit {1 << 2};
+std::uint8_t constexpr xdigit {1 << 3};
+std::uint8_t constexpr space {1 << 4};
+std::uint8_t constexpr punct {1 << 5};
+std::uint8_t constexpr alpha {lower | upper};
+std::uint8_t constexpr alnum {alpha | digit};
+
+} // namespace Class
+
+// build the ascii character class table at compile time
+// unlike <cctype>, lookups are locale independent and safe for any char value
+constexpr std::array<std::uint8_t, 256> make_class_table()
+{
+  std::array<std::uint8_t, 256> tbl {};
+
+  for (std::size_t c = 'a'; c <= 'z'; ++c)
+  {
+    tbl[c] |= Class::lower;
+  }
+
+  for (std::size_t c = 'A'; c <= 'Z'; ++c)
+  {
+    tbl[c] |= Class::upper;
+  }
+
+  for (std::size_t c = '0'; c <= '9'; ++c)
+  {
+    tbl[c] |= Class::digit | Class::xdigit;
+  }
+
+  for (std::size_t c = 'a'; c <= 'f'; ++c)
+  {
+    tbl[c] |= Class::xdigit;
+    tbl[c - 'a' + 'A'] |= Class::xdigit;
+  }
+
+  for (char const c : {' ', '\t', '\n', '\v', '\f', '\r'})
+  {
+    tbl[static_cast<unsigned char>(c)] |= Class::space;
+  }
+
+  for (std::size_t c = '!'; c <= '~'; ++c)
+  {
+    if (! tbl[c])
+    {
+      tbl[c] |= Class::punct;
+    }
+  }
+
+  return tbl;
+}
+
+inline constexpr std::array<std::uint8_t, 256> class_table {make_class_table()};
+
+// check if a character belongs to any of the classes in 'mask'
+constexpr bool is(char const c, std::uint8_t const mask)
+{
+  return class_table[static_cast<unsigned char>(c)] & mask;
+}
 
-bool assert_rx(std::string str, std::regex rx);
+// check if every character in 'str' belongs to the classes in 'mask'
+constexpr bool all_of(std::string_view const str, std::uint8_t const mask)
+{
+  for (auto const c : str)
+  {
+    if (! is(c, mask))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// check if 'str' exactly equals one of 'values'
+constexpr bool one_of(std::string_view const str, std::initializer_list<std::string_view> const values)
+{
+  for (auto const& e : values)
+  {
+    if (str == e)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// split 'str' on 'delim' into between 'min' and 'N' non-empty fields
+// unused trailing fields are left empty
+// returns an empty optional if the field count or any field is invalid
+template<std::size_t N>
+constexpr std::optional<std::array<std::string_view, N>> fields(std::string_view const str,
+  char const delim, std::size_t const min = N)
+{
+  std::array<std::string_view, N> res {};
+  std::size_t size {0};
+  std::size_t start {0};
+
+  for (;;)
+  {
+    auto const end = str.find(delim, start);
+    auto const field = str.substr(start, end == std::string_view::npos ? end : end - start);
 
-std::optional<std::vector<std::string>> match(std::string const& str, std::regex rx);
+    if (field.empty() || size == N)
+    {
+      return {};
+    }
+
+    res[size++] = field;
+
+    if (end == std::string_view::npos)
+    {
+      break;
+    }
+
+    start = end + 1;
+  }
+
+  if (size < min)
+  {
+    return {};
+  }
+
+  return res;
+}
+
+// copy 'str' with ascii upper case letters made lower case
+std::string lower(std::string_view str);
+
+std::vector<std::string> split(std::string const& str, std::string const& delim, std::size_t size = std::numeric_limits<std::size_t>::max());
 
 } // namespace OB::String
 
@@ -16,8 +16,6 @@
 #include <sstream>
 #include <string>
 #include <vector>
-#include <vector>
-#include <regex>
 #include <chrono>
 #include <thread>
 #include <utility>
@@ -235,26 +233,37 @@ inline std::string htoi(std::string const& str_)
 
 inline bool valid_hstr(std::string& str_)
 {
-  std::smatch m;
-  std::regex rx {"^#?((?:[0-9a-fA-F]{3}){1,2})$"};
+  // match an optional '#' followed by either 3 or 6 hex digits
+  std::size_t const begin {! str_.empty() && str_.front() == '#' ? 1ul : 0ul};
+  std::size_t const size {str_.size() - begin};
 
-  if (std::regex_match(str_, m, rx, std::regex_constants::match_not_null))
+  if (size != 3 && size != 6)
   {
-    std::string hstr {m[1]};
+    return false;
+  }
 
-    if (hstr.size() == 3)
+  for (std::size_t i = begin; i < str_.size(); ++i)
+  {
+    if (! std::isxdigit(static_cast<unsigned char>(str_[i])))
     {
-      std::stringstream ss;
-      ss << hstr[0] << hstr[0] << hstr[1] << hstr[1] << hstr[2] << hstr[2];
-      hstr = ss.str();
+      return false;
     }
+  }
 
-    str_ = hstr;
-
-    return true;
+  if (size == 3)
+  {
+    str_ = {
+      str_[begin], str_[begin],
+      str_[begin + 1], str_[begin + 1],
+      str_[begin + 2], str_[begin + 2]
+    };
+  }
+  else
+  {
+    str_.erase(0, begin);
   }
 
-  return false;
+  return true;
 }
 
 inline std::string fg_true(std::string str_)
@@ -428,7 +437,7 @@ protected:
             _buffer.erase(_buffer.size() - 1);
           }
 
-          _streambuf->sputn(_prefix.data(), static_cast<std::streamsize>(_prefix.size()));
+          put_prefix();
           _streambuf->sputn(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
         }
         else
@@ -440,6 +449,7 @@ protected:
       }
 
       _size = 0;
+      _hanging = false;
       _buffer.clear();
       _esc_seq.clear();
 
@@ -542,8 +552,67 @@ protected:
       return *this;
     }
 
+    streambuf& hang(std::size_t val_)
+    {
+      _hang = val_;
+
+      return *this;
+    }
+
   protected:
 
+    // width of the prefix of the current line
+    std::size_t margin() const
+    {
+      return _prefix.size() + (_hanging ? _hang : 0);
+    }
+
+    // number of chars in 'str_' that take up space on the line
+    static std::size_t visible(string const& str_)
+    {
+      std::size_t res {0};
+
+      for (std::size_t i = 0; i < str_.size(); ++i)
+      {
+        if (str_[i] == '\x1b' && i + 1 < str_.size())
+        {
+          if (str_[i + 1] == '[')
+          {
+            for (i += 2; i < str_.size() && ! std::isalpha(static_cast<unsigned char>(str_[i])); ++i)
+            {
+            }
+          }
+          else if (str_[i + 1] == '(' || str_[i + 1] == ')' || str_[i + 1] == '#')
+          {
+            i += 2;
+          }
+          else
+          {
+            ++i;
+          }
+        }
+        else if (str_[i] != '\a')
+        {
+          ++res;
+        }
+      }
+
+      return res;
+    }
+
+    void put_prefix()
+    {
+      _streambuf->sputn(_prefix.data(), static_cast<std::streamsize>(_prefix.size()));
+
+      if (_hanging)
+      {
+        for (std::size_t i = 0; i < _hang; ++i)
+        {
+          _streambuf->sputc(' ');
+        }
+      }
+    }
+
     int_type overflow(int_type ch_)
     {
       if (traits_type::eq_int_type(traits_type::eof(), ch_))
@@ -624,20 +693,20 @@ protected:
             // don't wrap first line when level is 0
             // block left intentionally empty
           }
-          else if (_line_wrap && (_size + _indent >= _width - _prefix.size()))
+          else if (_line_wrap && (_size + _indent >= _width - margin()))
           {
             if (auto pos = _buffer.find_last_of(" ");
               _word_break && pos != string::npos)
             {
-              _streambuf->sputn(_prefix.data(), static_cast<std::streamsize>(_prefix.size()));
+              put_prefix();
               _streambuf->sputn(_buffer.data(), static_cast<std::streamsize>(pos));
 
-              _size = _buffer.size() - pos - 1;
               _buffer = _buffer.substr(pos + 1);
+              _size = visible(_buffer);
             }
             else
             {
-              _streambuf->sputn(_prefix.data(), static_cast<std::streamsize>(_prefix.size()));
+              put_prefix();
               _streambuf->sputn(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
 
               _size = 0;
@@ -645,6 +714,7 @@ protected:
             }
 
             _streambuf->sputc('\n');
+            _hanging = true;
           }
 
           if (_auto_wrap && _is_prefix)
@@ -697,11 +767,12 @@ protected:
             _buffer.erase(_buffer.size() - 1);
           }
 
-          _streambuf->sputn(_prefix.data(), static_cast<std::streamsize>(_prefix.size()));
+          put_prefix();
           _streambuf->sputn(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
           _streambuf->sputc(ch_);
 
           _size = 0;
+          _hanging = false;
           _buffer.clear();
 
           if (_auto_wrap)
@@ -721,7 +792,7 @@ protected:
             // don't wrap first line when level is 0
             // block left intentionally empty
           }
-          else if (_line_wrap && (_size + 1 + _prefix.size() >= _width))
+          else if (_line_wrap && (_size + 1 + margin() >= _width))
           {
             ++_size;
             _buffer += " ";
@@ -729,15 +800,15 @@ protected:
             if (auto pos = _buffer.find_last_of(" ");
                 _word_break && pos != string::npos)
             {
-              _streambuf->sputn(_prefix.data(), static_cast<std::streamsize>(_prefix.size()));
+              put_prefix();
               _streambuf->sputn(_buffer.data(), static_cast<std::streamsize>(pos));
 
-              _size = _buffer.size() - pos - 1;
               _buffer = _buffer.substr(pos + 1);
+              _size = visible(_buffer);
             }
             else
             {
-              _streambuf->sputn(_prefix.data(), static_cast<std::streamsize>(_prefix.size()));
+              put_prefix();
               _streambuf->sputn(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
 
               _size = 0;
@@ -745,6 +816,7 @@ protected:
             }
 
             _streambuf->sputc('\n');
+            _hanging = true;
 
             return ch_;
           }
@@ -775,20 +847,20 @@ protected:
             // don't wrap first line when level is 0
             // block left intentionally empty
           }
-          else if (_line_wrap && (_size + _prefix.size() >= _width))
+          else if (_line_wrap && (_size + margin() >= _width))
           {
             if (auto pos = _buffer.find_last_of(" ");
                 _word_break && pos != string::npos)
             {
-              _streambuf->sputn(_prefix.data(), static_cast<std::streamsize>(_prefix.size()));
+              put_prefix();
               _streambuf->sputn(_buffer.data(), static_cast<std::streamsize>(pos));
 
-              _size = _buffer.size() - pos - 1;
               _buffer = _buffer.substr(pos + 1);
+              _size = visible(_buffer);
             }
             else
             {
-              _streambuf->sputn(_prefix.data(), static_cast<std::streamsize>(_prefix.size()));
+              put_prefix();
               _streambuf->sputn(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
 
               _size = 0;
@@ -796,6 +868,7 @@ protected:
             }
 
             _streambuf->sputc('\n');
+            _hanging = true;
           }
 
           ++_size;
@@ -818,6 +891,12 @@ protected:
     // indentation level
     std::size_t _level {0};
 
+    // number of extra spaces to indent wrapped lines
+    std::size_t _hang {0};
+
+    // the current line was wrapped
+    bool _hanging {false};
+
     // stream should wrap around at output width
     bool _line_wrap {true};
 
@@ -949,6 +1028,13 @@ public:
     return *this;
   }
 
+  ostream& hang(std::size_t val_ = 0)
+  {
+    _stream.hang(val_);
+
+    return *this;
+  }
+
 protected:
 
   streambuf _stream;
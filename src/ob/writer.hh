@@ -0,0 +1,178 @@
+#ifndef OB_WRITER_HH
+#define OB_WRITER_HH
+
+#include <sys/uio.h>
+#include <unistd.h>
+#include <limits.h>
+
+#include <cerrno>
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <algorithm>
+#include <type_traits>
+
+namespace OB
+{
+
+// buffered output to a file descriptor
+// short strings are copied into a single buffer, long strings are
+// referenced in place and written along with the buffer using writev
+// referenced strings must stay valid until the next flush
+class Writer
+{
+public:
+
+  explicit Writer(int fd_) :
+    _fd {fd_}
+  {
+    _buf.reserve(_buf_max);
+  }
+
+  Writer(Writer const&) = delete;
+  Writer& operator=(Writer const&) = delete;
+
+  ~Writer()
+  {
+    flush();
+  }
+
+  // copy 'str_' into the buffer
+  Writer& put(std::string_view str_)
+  {
+    _buf.append(str_);
+    extend(str_.size());
+
+    return *this;
+  }
+
+  Writer& put(char c_)
+  {
+    _buf += c_;
+    extend(1);
+
+    return *this;
+  }
+
+  // write an integer in decimal
+  template<typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+  Writer& num(T val_)
+  {
+    char str[24];
+    auto const res = std::to_chars(str, str + sizeof(str), val_);
+
+    return put(std::string_view(str, static_cast<std::size_t>(res.ptr - str)));
+  }
+
+  // write 'str_' without copying it if it is long enough to be worth a separate iovec
+  Writer& ref(std::string_view str_)
+  {
+    if (str_.size() < _ref_min)
+    {
+      return put(str_);
+    }
+
+    _segs.emplace_back(Seg {str_.data(), 0, str_.size()});
+
+    if (_segs.size() >= _segs_max)
+    {
+      flush();
+    }
+
+    return *this;
+  }
+
+  // write everything that is pending, returns false on a write error
+  bool flush()
+  {
+    std::vector<iovec> iov;
+    iov.reserve(_segs.size());
+
+    for (auto const& e : _segs)
+    {
+      iov.emplace_back(iovec {const_cast<char*>(e.ptr ? e.ptr : _buf.data() + e.off), e.len});
+    }
+
+    _segs.clear();
+
+    bool res {true};
+    std::size_t pos {0};
+
+    while (pos < iov.size())
+    {
+      auto const count = static_cast<int>(std::min<std::size_t>(iov.size() - pos, IOV_MAX));
+      auto const n = ::writev(_fd, iov.data() + pos, count);
+
+      if (n < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+
+        res = false;
+        break;
+      }
+
+      // skip the fully written iovecs and trim a partially written one
+      auto len = static_cast<std::size_t>(n);
+
+      while (pos < iov.size() && len >= iov.at(pos).iov_len)
+      {
+        len -= iov.at(pos).iov_len;
+        ++pos;
+      }
+
+      if (pos < iov.size())
+      {
+        iov.at(pos).iov_base = static_cast<char*>(iov.at(pos).iov_base) + len;
+        iov.at(pos).iov_len -= len;
+      }
+    }
+
+    _buf.clear();
+
+    return res;
+  }
+
+private:
+
+  // a run of the buffer at 'off' when 'ptr' is null, otherwise a referenced string
+  struct Seg
+  {
+    char const* ptr;
+    std::size_t off;
+    std::size_t len;
+  }; // struct Seg
+
+  // account for 'len_' bytes just appended to the buffer
+  void extend(std::size_t len_)
+  {
+    if (_segs.empty() || _segs.back().ptr)
+    {
+      _segs.emplace_back(Seg {nullptr, _buf.size() - len_, 0});
+    }
+
+    _segs.back().len += len_;
+
+    if (_buf.size() >= _buf_max)
+    {
+      flush();
+    }
+  }
+
+  static constexpr std::size_t _buf_max {1 << 16};
+  static constexpr std::size_t _segs_max {IOV_MAX};
+  static constexpr std::size_t _ref_min {128};
+
+  int _fd;
+  std::string _buf;
+  std::vector<Seg> _segs;
+}; // class Writer
+
+} // namespace OB
+
+#endif // OB_WRITER_HH
@@ -0,0 +1,228 @@
+#include "stig/cache.hh"
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <optional>
+#include <filesystem>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace OB::Stig::Cache
+{
+
+// prototypes
+fs::path file(std::string const& key);
+fs::path temp(fs::path const& path);
+
+fs::path dir()
+{
+  if (auto const env = std::getenv("XDG_CACHE_HOME"); env && *env)
+  {
+    return fs::path(env) / "stig";
+  }
+
+  if (auto const env = std::getenv("HOME"); env && *env)
+  {
+    return fs::path(env) / ".cache" / "stig";
+  }
+
+  return {};
+}
+
+fs::path file(std::string const& key)
+{
+  auto const base = dir();
+
+  if (base.empty())
+  {
+    return {};
+  }
+
+  // name the file after the 64-bit FNV-1a hash of the key
+  std::uint64_t hash {0xcbf29ce484222325};
+
+  for (auto const c : key)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3;
+  }
+
+  char constexpr hex[] {"0123456789abcdef"};
+  std::string name (16, '0');
+
+  for (std::size_t i = 0; i < name.size(); ++i)
+  {
+    name[name.size() - 1 - i] = hex[(hash >> (i * 4)) & 0xf];
+  }
+
+  return base / name;
+}
+
+fs::path temp(fs::path const& path)
+{
+  // unique to the process and the write, so concurrent writers of the same entry
+  // each rename a whole file into place instead of sharing one
+  static std::atomic<unsigned long int> count {0};
+
+  auto res = path;
+  res += "." + std::to_string(getpid()) + "." + std::to_string(count.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+
+  return res;
+}
+
+std::optional<Entry> map(std::string const& key, std::chrono::seconds max_age)
+{
+  auto const path = file(key);
+
+  if (path.empty())
+  {
+    return {};
+  }
+
+  std::error_code ec;
+  auto const mtime = fs::last_write_time(path, ec);
+
+  if (ec || fs::file_time_type::clock::now() - mtime > max_age)
+  {
+    return {};
+  }
+
+  Entry res;
+
+  if (! res.map.open(path.string()))
+  {
+    return {};
+  }
+
+  // the key is stored on the first line to guard against hash collisions
+  auto const data = res.map.view();
+  auto const end = data.find('\n');
+
+  if (end == std::string_view::npos || data.substr(0, end) != key)
+  {
+    return {};
+  }
+
+  res.val = data.substr(end + 1);
+
+  return res;
+}
+
+std::optional<std::string> get(std::string const& key, std::chrono::seconds max_age)
+{
+  if (auto const entry = map(key, max_age))
+  {
+    return std::string(entry->val);
+  }
+
+  return {};
+}
+
+void set(std::string const& key, std::string const& val)
+{
+  Writer writer {key};
+  writer.append(val);
+  writer.commit();
+}
+
+Writer::Writer(std::string const& key) :
+  _path {file(key)}
+{
+  if (_path.empty())
+  {
+    return;
+  }
+
+  std::error_code ec;
+  fs::create_directories(_path.parent_path(), ec);
+
+  if (ec)
+  {
+    return;
+  }
+
+  // write to a temporary file and rename it into place
+  // so that concurrent readers never see a partial entry
+  _tmp = temp(_path);
+
+  _ofs.open(_tmp, std::ios::binary | std::ios::trunc);
+  _ofs << key << "\n";
+}
+
+Writer::~Writer()
+{
+  if (_ofs.is_open())
+  {
+    _ofs.close();
+
+    std::error_code ec;
+    fs::remove(_tmp, ec);
+  }
+}
+
+void Writer::append(std::string_view data)
+{
+  if (_ofs.is_open())
+  {
+    _ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+  }
+}
+
+void Writer::commit()
+{
+  if (! _ofs.is_open())
+  {
+    return;
+  }
+
+  std::error_code ec;
+
+  if (! _ofs.flush())
+  {
+    _ofs.close();
+    fs::remove(_tmp, ec);
+
+    return;
+  }
+
+  _ofs.close();
+  fs::rename(_tmp, _path, ec);
+}
+
+bool write(fs::path const& path, std::string_view data)
+{
+  std::error_code ec;
+  fs::create_directories(path.parent_path(), ec);
+
+  if (ec)
+  {
+    return false;
+  }
+
+  auto const tmp = temp(path);
+
+  {
+    std::ofstream ofs {tmp, std::ios::binary | std::ios::trunc};
+
+    if (! ofs || ! ofs.write(data.data(), static_cast<std::streamsize>(data.size())).flush())
+    {
+      fs::remove(tmp, ec);
+      return false;
+    }
+  }
+
+  fs::rename(tmp, path, ec);
+
+  return ! ec;
+}
+
+} // namespace OB::Stig::Cache
@@ -0,0 +1,71 @@
+#ifndef OB_STIG_CACHE_HH
+#define OB_STIG_CACHE_HH
+
+#include "ob/mmap.hh"
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <optional>
+#include <filesystem>
+
+namespace OB::Stig::Cache
+{
+
+// get the cache directory, '$XDG_CACHE_HOME/stig' or '$HOME/.cache/stig'
+// returns an empty path if neither environment variable is set
+std::filesystem::path dir();
+
+struct Entry
+{
+  OB::Mmap map;
+
+  // the stored value, a view into 'map'
+  std::string_view val;
+}; // struct Entry
+
+// memory map the value stored for 'key' if it is no older than 'max_age'
+std::optional<Entry> map(std::string const& key, std::chrono::seconds max_age);
+
+// get the value stored for 'key' if it is no older than 'max_age'
+std::optional<std::string> get(std::string const& key, std::chrono::seconds max_age);
+
+// store 'val' for 'key'
+// the cache is best effort, failures are silently ignored
+void set(std::string const& key, std::string const& val);
+
+// stream a value into the cache for 'key'
+// the value replaces the stored one when 'commit' is called,
+// and is discarded if the writer is destroyed first
+// the cache is best effort, failures are silently ignored
+class Writer
+{
+public:
+
+  explicit Writer(std::string const& key);
+
+  Writer(Writer const&) = delete;
+  Writer& operator=(Writer const&) = delete;
+
+  ~Writer();
+
+  void append(std::string_view data);
+
+  void commit();
+
+private:
+
+  std::filesystem::path _path;
+  std::filesystem::path _tmp;
+  std::ofstream _ofs;
+}; // class Writer
+
+// replace the file at 'path' with 'data'
+// readers see either the old or the new contents, never a partial write
+// returns false on failure
+bool write(std::filesystem::path const& path, std::string_view data);
+
+} // namespace OB::Stig::Cache
+
+#endif // OB_STIG_CACHE_HH
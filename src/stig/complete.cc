@@ -0,0 +1,203 @@
+#include "stig/complete.hh"
+
+#include "stig/lang.hh"
+#include "stig/cache.hh"
+
+#include "ob/mmap.hh"
+
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <ostream>
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace OB::Stig::Complete
+{
+
+// search qualifiers accepted by the GitHub repository search
+constexpr std::array<std::string_view, 16> qualifiers {
+  "archived:",
+  "created:",
+  "fork:",
+  "forks:",
+  "good-first-issues:",
+  "help-wanted-issues:",
+  "in:",
+  "is:",
+  "language:",
+  "license:",
+  "org:",
+  "pushed:",
+  "size:",
+  "stars:",
+  "topic:",
+  "user:",
+};
+
+// prototypes
+fs::path path();
+std::size_t lower_bound(std::string_view data, std::string_view key);
+
+fs::path path()
+{
+  auto const dir = Cache::dir();
+
+  if (dir.empty())
+  {
+    return {};
+  }
+
+  return dir / "complete";
+}
+
+// find the offset of the first line not less than 'key'
+// 'data' must be a sorted list of lines
+std::size_t lower_bound(std::string_view data, std::string_view key)
+{
+  // 'lo' is always the start of a line
+  // 'hi' is either the start of a line or the end of the data
+  std::size_t lo {0};
+  std::size_t hi {data.size()};
+
+  while (lo < hi)
+  {
+    auto const mid = lo + (hi - lo) / 2;
+
+    // find the bounds of the line containing 'mid'
+    auto begin = mid ? data.rfind('\n', mid - 1) : std::string_view::npos;
+    begin = (begin == std::string_view::npos || begin < lo) ? lo : begin + 1;
+
+    auto end = data.find('\n', begin);
+    end = end == std::string_view::npos ? data.size() : end;
+
+    if (data.substr(begin, end - begin) < key)
+    {
+      lo = std::min(end + 1, hi);
+    }
+    else
+    {
+      hi = begin;
+    }
+  }
+
+  return lo;
+}
+
+void add(std::vector<std::string> names)
+{
+  auto const file = path();
+
+  if (file.empty() || names.empty())
+  {
+    return;
+  }
+
+  std::sort(names.begin(), names.end());
+  names.erase(std::unique(names.begin(), names.end()), names.end());
+
+  // merge the new names with the existing sorted index
+  OB::Mmap map {file.string()};
+  auto data = map.view();
+  std::string res;
+  res.reserve(data.size() + names.size() * 32);
+
+  auto it = names.begin();
+
+  while (! data.empty() || it != names.end())
+  {
+    auto const end = data.find('\n');
+    auto const line = data.substr(0, end);
+
+    if (! data.empty() && (it == names.end() || line <= *it))
+    {
+      if (it != names.end() && line == *it)
+      {
+        ++it;
+      }
+
+      res.append(line).append("\n");
+      data.remove_prefix(end == std::string_view::npos ? data.size() : end + 1);
+    }
+    else
+    {
+      res.append(*it).append("\n");
+      ++it;
+    }
+  }
+
+  if (res.size() == map.size())
+  {
+    // nothing new to add
+    return;
+  }
+
+  Cache::write(file, res);
+}
+
+void print(std::string_view prefix, std::ostream& os)
+{
+  // language qualifier values
+  if (std::string_view const key {"language:"};
+    prefix.size() >= key.size() && prefix.substr(0, key.size()) == key)
+  {
+    auto const value = Lang::qualifier(prefix.substr(key.size()));
+
+    for (std::size_t i = 0; i < Lang::size(); ++i)
+    {
+      auto const name = Lang::qualifier(Lang::at(i).name);
+
+      if (name.compare(0, value.size(), value) == 0)
+      {
+        os << key << name << "\n";
+      }
+    }
+
+    return;
+  }
+
+  // qualifier keys
+  if (prefix.find_first_of(":/") == std::string_view::npos)
+  {
+    for (auto const& e : qualifiers)
+    {
+      if (e.substr(0, prefix.size()) == prefix)
+      {
+        os << e << "\n";
+      }
+    }
+  }
+
+  // user/repo names
+  auto const file = path();
+
+  if (file.empty())
+  {
+    return;
+  }
+
+  OB::Mmap map {file.string()};
+  auto data = map.view();
+  data.remove_prefix(lower_bound(data, prefix));
+
+  while (! data.empty())
+  {
+    auto const end = data.find('\n');
+    auto const line = data.substr(0, end);
+
+    if (line.substr(0, prefix.size()) != prefix)
+    {
+      break;
+    }
+
+    os << line << "\n";
+    data.remove_prefix(end == std::string_view::npos ? data.size() : end + 1);
+  }
+}
+
+} // namespace OB::Stig::Complete
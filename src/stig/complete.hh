@@ -0,0 +1,22 @@
+#ifndef OB_STIG_COMPLETE_HH
+#define OB_STIG_COMPLETE_HH
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ostream>
+
+namespace OB::Stig::Complete
+{
+
+// merge 'user/repo' names into the completion index stored in the cache directory
+// the index is a sorted file with one name per line
+void add(std::vector<std::string> names);
+
+// print each completion starting with 'prefix' to 'os', one per line
+// completes search qualifier keys, 'language:' values, and 'user/repo' names
+void print(std::string_view prefix, std::ostream& os);
+
+} // namespace OB::Stig::Complete
+
+#endif // OB_STIG_COMPLETE_HH
@@ -0,0 +1,302 @@
+#include "stig/format.hh"
+#include "stig/time.hh"
+
+#include "ob/writer.hh"
+
+#include <cstddef>
+
+#include <string_view>
+#include <vector>
+#include <array>
+#include <type_traits>
+
+namespace OB::Stig::Format
+{
+
+// prototypes
+void json_string(OB::Writer& out, std::string_view str);
+void json_repo(OB::Writer& out, Repo const& repo);
+void tsv_string(OB::Writer& out, std::string_view str);
+void csv_string(OB::Writer& out, std::string_view str);
+template<typename D, typename F> void text(OB::Writer& out, Repo const& repo, F const& str);
+template<typename F> void row(OB::Writer& out, Repo const& repo, char delim, F const& str);
+
+void json_string(OB::Writer& out, std::string_view str)
+{
+  char constexpr hex[] {"0123456789abcdef"};
+
+  out.put('"');
+
+  // copy the runs that need no escaping as they are
+  std::size_t begin {0};
+
+  for (std::size_t i = 0; i < str.size(); ++i)
+  {
+    auto const c = static_cast<unsigned char>(str[i]);
+
+    if (c >= 0x20 && c != '"' && c != '\\')
+    {
+      continue;
+    }
+
+    out.ref(str.substr(begin, i - begin));
+    begin = i + 1;
+
+    switch (c)
+    {
+      case '"': out.put("\\\""); break;
+      case '\\': out.put("\\\\"); break;
+      case '\n': out.put("\\n"); break;
+      case '\r': out.put("\\r"); break;
+      case '\t': out.put("\\t"); break;
+      case '\b': out.put("\\b"); break;
+      case '\f': out.put("\\f"); break;
+      default: out.put("\\u00").put(hex[c >> 4]).put(hex[c & 0xf]); break;
+    }
+  }
+
+  out.ref(str.substr(begin));
+  out.put('"');
+}
+
+void json_repo(OB::Writer& out, Repo const& repo)
+{
+  auto const nullable = [&](std::string_view str)
+  {
+    if (str.empty())
+    {
+      out.put("null");
+    }
+    else
+    {
+      json_string(out, str);
+    }
+  };
+
+  char sep {'{'};
+
+  for_each_field([&](auto const& e)
+  {
+    using D = std::decay_t<decltype(e)>;
+    auto const& val = repo.*D::member;
+
+    out.put(sep).put('"').put(e.name).put("\":");
+    sep = ',';
+
+    if constexpr (D::kind == Field_Kind::number)
+    {
+      out.num(val);
+    }
+    else if constexpr (D::kind == Field_Kind::boolean)
+    {
+      out.put(val ? "true" : "false");
+    }
+    else if constexpr (D::kind == Field_Kind::string)
+    {
+      json_string(out, val);
+    }
+    else if constexpr (D::kind == Field_Kind::nullable)
+    {
+      nullable(val);
+    }
+    else if constexpr (D::kind == Field_Kind::strings)
+    {
+      out.put('[');
+
+      for (std::size_t i = 0; i < val.size(); ++i)
+      {
+        if (i)
+        {
+          out.put(',');
+        }
+
+        json_string(out, val.at(i));
+      }
+
+      out.put(']');
+    }
+    else if constexpr (D::kind == Field_Kind::time)
+    {
+      std::array<char, 24> buf;
+      nullable(iso_time(val, buf));
+    }
+  });
+
+  out.put('}');
+}
+
+// escape the characters that would break a tab separated row
+void tsv_string(OB::Writer& out, std::string_view str)
+{
+  std::size_t begin {0};
+
+  for (std::size_t i = 0; i < str.size(); ++i)
+  {
+    auto const c = str[i];
+
+    if (c != '\t' && c != '\n' && c != '\r' && c != '\\')
+    {
+      continue;
+    }
+
+    out.ref(str.substr(begin, i - begin));
+    begin = i + 1;
+    out.put('\\').put(c == '\t' ? 't' : c == '\n' ? 'n' : c == '\r' ? 'r' : '\\');
+  }
+
+  out.ref(str.substr(begin));
+}
+
+// quote a field as described in RFC 4180 when it contains a special character
+void csv_string(OB::Writer& out, std::string_view str)
+{
+  if (str.find_first_of(",\"\r\n") == std::string_view::npos)
+  {
+    out.ref(str);
+    return;
+  }
+
+  out.put('"');
+
+  std::size_t begin {0};
+
+  for (auto pos = str.find('"'); pos != std::string_view::npos; pos = str.find('"', begin))
+  {
+    out.ref(str.substr(begin, pos + 1 - begin)).put('"');
+    begin = pos + 1;
+  }
+
+  out.ref(str.substr(begin));
+  out.put('"');
+}
+
+// write the field described by 'D' as text, passing its strings through 'str'
+template<typename D, typename F>
+void text(OB::Writer& out, Repo const& repo, F const& str)
+{
+  auto const& val = repo.*D::member;
+
+  if constexpr (D::kind == Field_Kind::number)
+  {
+    out.num(val);
+  }
+  else if constexpr (D::kind == Field_Kind::boolean)
+  {
+    out.put(val ? "true" : "false");
+  }
+  else if constexpr (D::kind == Field_Kind::strings)
+  {
+    // topics never contain a space
+    for (std::size_t i = 0; i < val.size(); ++i)
+    {
+      if (i)
+      {
+        out.put(' ');
+      }
+
+      str(out, val.at(i));
+    }
+  }
+  else if constexpr (D::kind == Field_Kind::time)
+  {
+    std::array<char, 24> buf;
+    out.put(iso_time(val, buf));
+  }
+  else
+  {
+    str(out, val);
+  }
+}
+
+template<typename F>
+void row(OB::Writer& out, Repo const& repo, char delim, F const& str)
+{
+  std::size_t i {0};
+
+  for_each_field([&](auto const& e)
+  {
+    if (i++)
+    {
+      out.put(delim);
+    }
+
+    text<std::decay_t<decltype(e)>>(out, repo, str);
+  });
+
+  out.put('\n');
+}
+
+void field(OB::Writer& out, Repo const& repo, std::size_t pos)
+{
+  visit_field(pos, [&](auto const& e)
+  {
+    text<std::decay_t<decltype(e)>>(out, repo, [](OB::Writer& dst, std::string_view str)
+    {
+      dst.ref(str);
+    });
+  });
+}
+
+void write(int fd, std::string_view format, std::vector<Repo> const& repos, std::size_t total)
+{
+  OB::Writer out {fd};
+
+  if (format == "ndjson")
+  {
+    for (auto const& e : repos)
+    {
+      json_repo(out, e);
+      out.put('\n');
+    }
+  }
+  else if (format == "json")
+  {
+    out.put("{\"total_count\":").num(total).put(",\"items\":[");
+
+    for (std::size_t i = 0; i < repos.size(); ++i)
+    {
+      if (i)
+      {
+        out.put(',');
+      }
+
+      json_repo(out, repos.at(i));
+    }
+
+    out.put("]}\n");
+  }
+  else
+  {
+    char const delim {format == "csv" ? ',' : '\t'};
+
+    std::size_t i {0};
+
+    for_each_field([&](auto const& e)
+    {
+      if (i++)
+      {
+        out.put(delim);
+      }
+
+      out.put(e.name);
+    });
+
+    out.put('\n');
+
+    for (auto const& e : repos)
+    {
+      if (delim == ',')
+      {
+        row(out, e, delim, csv_string);
+      }
+      else
+      {
+        row(out, e, delim, tsv_string);
+      }
+    }
+  }
+
+  out.flush();
+}
+
+} // namespace OB::Stig::Format
@@ -0,0 +1,26 @@
+#ifndef OB_STIG_FORMAT_HH
+#define OB_STIG_FORMAT_HH
+
+#include "stig/repo.hh"
+
+#include "ob/writer.hh"
+
+#include <cstddef>
+
+#include <string_view>
+#include <vector>
+
+namespace OB::Stig::Format
+{
+
+// write 'repos' to the file descriptor 'fd' in a machine readable format
+// 'format' is one of 'ndjson', 'json', 'tsv', or 'csv'
+// 'total' is the number of results the query matched
+void write(int fd, std::string_view format, std::vector<Repo> const& repos, std::size_t total);
+
+// write the field at 'pos' in 'repo_fields' as plain text
+void field(OB::Writer& out, Repo const& repo, std::size_t pos);
+
+} // namespace OB::Stig::Format
+
+#endif // OB_STIG_FORMAT_HH
@@ -0,0 +1,709 @@
+#include "stig/highlight.hh"
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <utility>
+#include <algorithm>
+
+namespace OB::Stig::Highlight
+{
+
+// the class of each byte, the columns of the transition tables
+enum Class : std::uint8_t
+{
+  c_other,
+  c_space,
+  c_alpha,
+  c_digit,
+  c_dot,
+  c_dq,
+  c_sq,
+  c_bq,
+  c_slash,
+  c_star,
+  c_hash,
+  c_backslash,
+  c_dollar,
+  c_lbrace,
+  c_rbrace,
+  c_size,
+}; // enum Class
+
+enum State : std::uint8_t
+{
+  // the start of a line, before anything but whitespace
+  s_bol,
+  s_text,
+  s_ident,
+  s_number,
+  // a '/' that may begin a comment
+  s_slash,
+  s_line,
+  s_block,
+  s_block_star,
+  s_dq,
+  s_dq_esc,
+  s_sq,
+  s_sq_esc,
+  s_bq,
+  s_bq_esc,
+  // the opening quote of a string that may be triple quoted, then an empty string
+  s_dq1,
+  s_dq2,
+  s_tdq,
+  s_tdq_esc,
+  s_tdq1,
+  s_tdq2,
+  s_sq1,
+  s_sq2,
+  s_tsq,
+  s_tsq_esc,
+  s_tsq1,
+  s_tsq2,
+  s_var,
+  s_var_brace,
+  s_preproc,
+  s_size,
+}; // enum State
+
+// what a state is a part of, a span ends where this changes
+enum Kind : std::uint8_t
+{
+  k_text,
+  k_ident,
+  k_number,
+  k_comment,
+  k_string,
+  k_variable,
+  k_preproc,
+}; // enum Kind
+
+// where the byte that causes a transition goes
+enum Mode : std::uint8_t
+{
+  // starts the next span if the kind changes
+  m_next,
+  // ends the current span
+  m_close,
+  // starts the next span along with the byte before it
+  m_back,
+}; // enum Mode
+
+// language features
+enum Flag : unsigned
+{
+  // '//' and '/* */' comments
+  f_slash = 1 << 0,
+  // '#' comments
+  f_hash = 1 << 1,
+  // a '#' at the start of a line begins a preprocessor directive
+  f_preproc = 1 << 2,
+  f_sq = 1 << 3,
+  f_sq_esc = 1 << 4,
+  f_bq = 1 << 5,
+  f_bq_esc = 1 << 6,
+  // '"""' and ''' strings
+  f_triple = 1 << 7,
+  // '$name' and '${name}' variables, a '#' inside a word is not a comment
+  f_vars = 1 << 8,
+  // '$' is part of an identifier
+  f_dollar = 1 << 9,
+  // '"' and ''' strings continue onto the next line
+  f_multiline = 1 << 10,
+}; // enum Flag
+
+struct Trans
+{
+  std::uint8_t next {s_text};
+  std::uint8_t mode {m_next};
+}; // struct Trans
+
+using Row = std::array<Trans, c_size>;
+using Table = std::array<Row, s_size>;
+struct Lexer
+{
+  Table table;
+
+  // the state a line ending in each state leaves for the next line
+  std::array<std::uint8_t, s_size> eol;
+
+  // sorted for binary search
+  std::string_view const* keywords;
+  std::size_t keywords_size;
+  std::string_view const* types;
+  std::size_t types_size;
+}; // struct Lexer
+
+// prototypes
+constexpr std::array<std::uint8_t, 256> classes();
+constexpr std::array<std::uint8_t, s_size> kinds();
+constexpr Row fill(std::uint8_t next);
+constexpr Row start(unsigned flags);
+constexpr void quoted(Table& table, std::uint8_t state, std::uint8_t esc, std::uint8_t quote, bool escapes);
+constexpr void triple(Table& table, std::uint8_t open, std::uint8_t empty, std::uint8_t state,
+  std::uint8_t quote);
+constexpr Table build(unsigned flags);
+constexpr std::array<std::uint8_t, s_size> eol(unsigned flags);
+template<std::size_t K, std::size_t T>
+constexpr Lexer lexer(unsigned flags, std::array<std::string_view, K> const& keywords,
+  std::array<std::string_view, T> const& types);
+template<typename T, std::size_t N>
+constexpr bool is_sorted(std::array<T, N> const& arr);
+Token token(Lexer const& lexer, std::uint8_t kind, std::string_view str);
+
+constexpr std::array<std::uint8_t, 256> classes()
+{
+  std::array<std::uint8_t, 256> res {};
+
+  for (std::size_t i = 0; i < res.size(); ++i)
+  {
+    if ((i >= 'a' && i <= 'z') || (i >= 'A' && i <= 'Z') || i == '_' || i >= 0x80)
+    {
+      res[i] = c_alpha;
+    }
+    else if (i >= '0' && i <= '9')
+    {
+      res[i] = c_digit;
+    }
+    else
+    {
+      switch (i)
+      {
+        case ' ': case '\t': res[i] = c_space; break;
+        case '.': res[i] = c_dot; break;
+        case '"': res[i] = c_dq; break;
+        case '\'': res[i] = c_sq; break;
+        case '`': res[i] = c_bq; break;
+        case '/': res[i] = c_slash; break;
+        case '*': res[i] = c_star; break;
+        case '#': res[i] = c_hash; break;
+        case '\\': res[i] = c_backslash; break;
+        case '$': res[i] = c_dollar; break;
+        case '{': res[i] = c_lbrace; break;
+        case '}': res[i] = c_rbrace; break;
+        default: res[i] = c_other; break;
+      }
+    }
+  }
+
+  return res;
+}
+
+constexpr std::array<std::uint8_t, s_size> kinds()
+{
+  std::array<std::uint8_t, s_size> res {};
+
+  for (std::size_t i = 0; i < res.size(); ++i)
+  {
+    switch (i)
+    {
+      case s_ident: res[i] = k_ident; break;
+      case s_number: res[i] = k_number; break;
+      case s_line: case s_block: case s_block_star: res[i] = k_comment; break;
+      case s_var: case s_var_brace: res[i] = k_variable; break;
+      case s_preproc: res[i] = k_preproc; break;
+      case s_bol: case s_text: case s_slash: res[i] = k_text; break;
+      default: res[i] = k_string; break;
+    }
+  }
+
+  return res;
+}
+
+std::array<std::uint8_t, 256> constexpr byte_class {classes()};
+std::array<std::uint8_t, s_size> constexpr state_kind {kinds()};
+
+// every byte goes to 'next'
+constexpr Row fill(std::uint8_t next)
+{
+  Row res {};
+
+  for (auto& e : res)
+  {
+    e = Trans {next, m_next};
+  }
+
+  return res;
+}
+
+// the transitions out of plain text, where a byte may begin a token
+constexpr Row start(unsigned flags)
+{
+  auto res = fill(s_text);
+
+  res[c_alpha] = Trans {s_ident, m_next};
+  res[c_digit] = Trans {s_number, m_next};
+  res[c_dq] = Trans {flags & f_triple ? s_dq1 : s_dq, m_next};
+
+  if (flags & f_sq)
+  {
+    res[c_sq] = Trans {flags & f_triple ? s_sq1 : s_sq, m_next};
+  }
+
+  if (flags & f_bq)
+  {
+    res[c_bq] = Trans {s_bq, m_next};
+  }
+
+  if (flags & f_slash)
+  {
+    res[c_slash] = Trans {s_slash, m_next};
+  }
+
+  if (flags & f_hash)
+  {
+    res[c_hash] = Trans {s_line, m_next};
+  }
+
+  if (flags & f_vars)
+  {
+    res[c_dollar] = Trans {s_var, m_next};
+  }
+  else if (flags & f_dollar)
+  {
+    res[c_dollar] = Trans {s_ident, m_next};
+  }
+
+  return res;
+}
+
+// a string closed by 'quote'
+constexpr void quoted(Table& table, std::uint8_t state, std::uint8_t esc, std::uint8_t quote, bool escapes)
+{
+  table[state] = fill(state);
+  table[state][quote] = Trans {s_text, m_close};
+
+  if (escapes)
+  {
+    table[state][c_backslash] = Trans {esc, m_next};
+  }
+
+  table[esc] = fill(state);
+}
+
+// a string that is triple quoted if it opens with three of 'quote'
+// 'open' follows the first quote and 'empty' the second,
+// 'state' to 'state + 3' are the body, an escape, and one and two closing quotes
+constexpr void triple(Table& table, std::uint8_t open, std::uint8_t empty, std::uint8_t state,
+  std::uint8_t quote)
+{
+  auto const single = quote == c_dq ? s_dq : s_sq;
+
+  table[open] = table[single];
+  table[open][quote] = Trans {empty, m_next};
+
+  auto const esc = static_cast<std::uint8_t>(state + 1);
+  auto const one = static_cast<std::uint8_t>(state + 2);
+  auto const two = static_cast<std::uint8_t>(state + 3);
+
+  table[state] = fill(state);
+  table[state][c_backslash] = Trans {esc, m_next};
+  table[state][quote] = Trans {one, m_next};
+
+  table[esc] = fill(state);
+
+  table[one] = table[state];
+  table[one][quote] = Trans {two, m_next};
+
+  table[two] = table[state];
+  table[two][quote] = Trans {s_text, m_close};
+}
+
+constexpr Table build(unsigned flags)
+{
+  Table res {};
+  auto const text = start(flags);
+
+  res[s_text] = text;
+
+  res[s_bol] = text;
+  res[s_bol][c_space] = Trans {s_bol, m_next};
+
+  if (flags & f_preproc)
+  {
+    res[s_bol][c_hash] = Trans {s_preproc, m_next};
+  }
+
+  res[s_ident] = text;
+  res[s_ident][c_alpha] = Trans {s_ident, m_next};
+  res[s_ident][c_digit] = Trans {s_ident, m_next};
+
+  if (flags & f_dollar)
+  {
+    res[s_ident][c_dollar] = Trans {s_ident, m_next};
+  }
+
+  if (flags & f_vars)
+  {
+    res[s_ident][c_hash] = Trans {s_ident, m_next};
+  }
+
+  res[s_number] = text;
+  res[s_number][c_alpha] = Trans {s_number, m_next};
+  res[s_number][c_digit] = Trans {s_number, m_next};
+  res[s_number][c_dot] = Trans {s_number, m_next};
+
+  res[s_slash] = text;
+  res[s_slash][c_slash] = Trans {s_line, m_back};
+  res[s_slash][c_star] = Trans {s_block, m_back};
+
+  res[s_line] = fill(s_line);
+
+  res[s_block] = fill(s_block);
+  res[s_block][c_star] = Trans {s_block_star, m_next};
+
+  res[s_block_star] = fill(s_block);
+  res[s_block_star][c_star] = Trans {s_block_star, m_next};
+  res[s_block_star][c_slash] = Trans {s_text, m_close};
+
+  quoted(res, s_dq, s_dq_esc, c_dq, true);
+  quoted(res, s_sq, s_sq_esc, c_sq, flags & f_sq_esc);
+  quoted(res, s_bq, s_bq_esc, c_bq, flags & f_bq_esc);
+
+  triple(res, s_dq1, s_dq2, s_tdq, c_dq);
+  triple(res, s_sq1, s_sq2, s_tsq, c_sq);
+
+  // the empty string is followed by plain text
+  res[s_dq2] = text;
+  res[s_dq2][c_dq] = Trans {s_tdq, m_next};
+  res[s_sq2] = text;
+  res[s_sq2][c_sq] = Trans {s_tsq, m_next};
+
+  res[s_var] = text;
+  res[s_var][c_alpha] = Trans {s_var, m_next};
+  res[s_var][c_digit] = Trans {s_var, m_next};
+  res[s_var][c_lbrace] = Trans {s_var_brace, m_next};
+
+  res[s_var_brace] = fill(s_var_brace);
+  res[s_var_brace][c_rbrace] = Trans {s_text, m_close};
+
+  res[s_preproc] = fill(s_preproc);
+
+  return res;
+}
+
+constexpr std::array<std::uint8_t, s_size> eol(unsigned flags)
+{
+  std::array<std::uint8_t, s_size> res {};
+
+  for (auto& e : res)
+  {
+    e = s_text;
+  }
+
+  res[s_block] = s_block;
+  res[s_block_star] = s_block;
+  res[s_bq] = s_bq;
+  res[s_bq_esc] = s_bq;
+
+  for (auto const e : {s_tdq, s_tdq_esc, s_tdq1, s_tdq2})
+  {
+    res[e] = s_tdq;
+  }
+
+  for (auto const e : {s_tsq, s_tsq_esc, s_tsq1, s_tsq2})
+  {
+    res[e] = s_tsq;
+  }
+
+  if (flags & f_multiline)
+  {
+    res[s_dq] = s_dq;
+    res[s_dq_esc] = s_dq;
+    res[s_sq] = s_sq;
+    res[s_sq_esc] = s_sq;
+  }
+
+  return res;
+}
+
+template<std::size_t K, std::size_t T>
+constexpr Lexer lexer(unsigned flags, std::array<std::string_view, K> const& keywords,
+  std::array<std::string_view, T> const& types)
+{
+  return Lexer {build(flags), eol(flags), keywords.data(), K, types.data(), T};
+}
+
+template<typename T, std::size_t N>
+constexpr bool is_sorted(std::array<T, N> const& arr)
+{
+  for (std::size_t i = 1; i < N; ++i)
+  {
+    if (! (arr[i - 1] < arr[i]))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::array<std::string_view, 30> constexpr c_keywords {{
+  "NULL", "auto", "break", "case", "const", "continue", "default", "do",
+  "else", "enum", "extern", "false", "for", "goto", "if", "inline", "register",
+  "restrict", "return", "signed", "sizeof", "static", "struct", "switch",
+  "true", "typedef", "union", "unsigned", "volatile", "while"
+}};
+
+std::array<std::string_view, 19> constexpr c_types {{
+  "FILE", "bool", "char", "double", "float", "int", "int16_t", "int32_t",
+  "int64_t", "int8_t", "long", "short", "size_t", "ssize_t", "uint16_t",
+  "uint32_t", "uint64_t", "uint8_t", "void"
+}};
+
+std::array<std::string_view, 70> constexpr cpp_keywords {{
+  "alignas", "alignof", "and", "asm", "auto", "break", "case", "catch",
+  "class", "co_await", "co_return", "co_yield", "const", "const_cast",
+  "consteval", "constexpr", "constinit", "continue", "decltype", "default",
+  "delete", "do", "dynamic_cast", "else", "enum", "explicit", "export",
+  "extern", "false", "final", "for", "friend", "goto", "if", "inline",
+  "mutable", "namespace", "new", "noexcept", "not", "nullptr", "operator",
+  "or", "override", "private", "protected", "public", "register",
+  "reinterpret_cast", "requires", "return", "sizeof", "static",
+  "static_assert", "static_cast", "struct", "switch", "template", "this",
+  "throw", "true", "try", "typedef", "typeid", "typename", "union", "using",
+  "virtual", "volatile", "while"
+}};
+
+std::array<std::string_view, 23> constexpr cpp_types {{
+  "bool", "char", "char16_t", "char32_t", "char8_t", "double", "float", "int",
+  "int16_t", "int32_t", "int64_t", "int8_t", "long", "short", "signed",
+  "size_t", "uint16_t", "uint32_t", "uint64_t", "uint8_t", "unsigned", "void",
+  "wchar_t"
+}};
+
+std::array<std::string_view, 38> constexpr rust_keywords {{
+  "Self", "as", "async", "await", "break", "const", "continue", "crate", "dyn",
+  "else", "enum", "extern", "false", "fn", "for", "if", "impl", "in", "let",
+  "loop", "match", "mod", "move", "mut", "pub", "ref", "return", "self",
+  "static", "struct", "super", "trait", "true", "type", "unsafe", "use",
+  "where", "while"
+}};
+
+std::array<std::string_view, 22> constexpr rust_types {{
+  "Box", "Option", "Result", "String", "Vec", "bool", "char", "f32", "f64",
+  "i128", "i16", "i32", "i64", "i8", "isize", "str", "u128", "u16", "u32",
+  "u64", "u8", "usize"
+}};
+
+std::array<std::string_view, 29> constexpr go_keywords {{
+  "break", "case", "chan", "const", "continue", "default", "defer", "else",
+  "fallthrough", "false", "for", "func", "go", "goto", "if", "import",
+  "interface", "iota", "map", "nil", "package", "range", "return", "select",
+  "struct", "switch", "true", "type", "var"
+}};
+
+std::array<std::string_view, 21> constexpr go_types {{
+  "any", "bool", "byte", "complex128", "complex64", "error", "float32",
+  "float64", "int", "int16", "int32", "int64", "int8", "rune", "string",
+  "uint", "uint16", "uint32", "uint64", "uint8", "uintptr"
+}};
+
+std::array<std::string_view, 35> constexpr python_keywords {{
+  "False", "None", "True", "and", "as", "assert", "async", "await", "break",
+  "class", "continue", "def", "del", "elif", "else", "except", "finally",
+  "for", "from", "global", "if", "import", "in", "is", "lambda", "nonlocal",
+  "not", "or", "pass", "raise", "return", "try", "while", "with", "yield"
+}};
+
+std::array<std::string_view, 10> constexpr python_types {{
+  "bool", "bytes", "dict", "float", "int", "list", "object", "set", "str",
+  "tuple"
+}};
+
+std::array<std::string_view, 49> constexpr js_keywords {{
+  "async", "await", "break", "case", "catch", "class", "const", "continue",
+  "debugger", "default", "delete", "do", "else", "enum", "export", "extends",
+  "false", "finally", "for", "function", "if", "implements", "import", "in",
+  "instanceof", "interface", "let", "new", "null", "of", "package", "private",
+  "protected", "public", "return", "static", "super", "switch", "this",
+  "throw", "true", "try", "typeof", "undefined", "var", "void", "while",
+  "with", "yield"
+}};
+
+std::array<std::string_view, 21> constexpr js_types {{
+  "Array", "Boolean", "Date", "Error", "JSON", "Map", "Math", "Number",
+  "Object", "Promise", "RegExp", "Set", "String", "Symbol", "any", "boolean",
+  "console", "never", "number", "string", "unknown"
+}};
+
+std::array<std::string_view, 15> constexpr shell_keywords {{
+  "case", "do", "done", "elif", "else", "esac", "fi", "for", "function", "if",
+  "in", "select", "then", "until", "while"
+}};
+
+std::array<std::string_view, 18> constexpr shell_types {{
+  "alias", "cd", "echo", "eval", "exec", "exit", "export", "local", "printf",
+  "read", "readonly", "return", "set", "shift", "source", "test", "trap",
+  "unset"
+}};
+
+static_assert(is_sorted(c_keywords) && is_sorted(c_types) &&
+  is_sorted(cpp_keywords) && is_sorted(cpp_types) &&
+  is_sorted(rust_keywords) && is_sorted(rust_types) &&
+  is_sorted(go_keywords) && is_sorted(go_types) &&
+  is_sorted(python_keywords) && is_sorted(python_types) &&
+  is_sorted(js_keywords) && is_sorted(js_types) &&
+  is_sorted(shell_keywords) && is_sorted(shell_types),
+  "keywords must be sorted");
+
+// built at compile time, so no work is done at program startup
+Lexer constexpr c_lexer {lexer(f_slash | f_preproc | f_sq | f_sq_esc, c_keywords, c_types)};
+Lexer constexpr cpp_lexer {lexer(f_slash | f_preproc | f_sq | f_sq_esc, cpp_keywords, cpp_types)};
+
+// a ''' is left alone so lifetimes are not taken for strings
+Lexer constexpr rust_lexer {lexer(f_slash | f_multiline, rust_keywords, rust_types)};
+
+Lexer constexpr go_lexer {lexer(f_slash | f_sq | f_sq_esc | f_bq, go_keywords, go_types)};
+Lexer constexpr python_lexer {lexer(f_hash | f_sq | f_sq_esc | f_triple, python_keywords, python_types)};
+Lexer constexpr js_lexer {lexer(f_slash | f_sq | f_sq_esc | f_bq | f_bq_esc | f_dollar, js_keywords, js_types)};
+Lexer constexpr shell_lexer {lexer(f_hash | f_sq | f_vars | f_multiline, shell_keywords, shell_types)};
+
+struct Name
+{
+  std::string_view name;
+  Lexer const* lexer;
+
+  friend constexpr bool operator<(Name const& lhs, Name const& rhs)
+  {
+    return lhs.name < rhs.name;
+  }
+}; // struct Name
+
+// fenced code block languages, sorted by name for binary search
+std::array<Name, 26> constexpr names {{
+  {"bash", &shell_lexer},
+  {"c", &c_lexer},
+  {"c++", &cpp_lexer},
+  {"cc", &cpp_lexer},
+  {"cpp", &cpp_lexer},
+  {"cxx", &cpp_lexer},
+  {"go", &go_lexer},
+  {"golang", &go_lexer},
+  {"h", &c_lexer},
+  {"hh", &cpp_lexer},
+  {"hpp", &cpp_lexer},
+  {"javascript", &js_lexer},
+  {"js", &js_lexer},
+  {"jsx", &js_lexer},
+  {"mjs", &js_lexer},
+  {"py", &python_lexer},
+  {"python", &python_lexer},
+  {"python3", &python_lexer},
+  {"rs", &rust_lexer},
+  {"rust", &rust_lexer},
+  {"sh", &shell_lexer},
+  {"shell", &shell_lexer},
+  {"ts", &js_lexer},
+  {"tsx", &js_lexer},
+  {"typescript", &js_lexer},
+  {"zsh", &shell_lexer},
+}};
+
+static_assert(is_sorted(names), "language names must be sorted");
+
+Token token(Lexer const& lexer, std::uint8_t kind, std::string_view str)
+{
+  switch (kind)
+  {
+    case k_ident:
+    {
+      if (std::binary_search(lexer.keywords, lexer.keywords + lexer.keywords_size, str))
+      {
+        return Token::keyword;
+      }
+
+      if (std::binary_search(lexer.types, lexer.types + lexer.types_size, str))
+      {
+        return Token::type;
+      }
+
+      return Token::text;
+    }
+    case k_number: return Token::number;
+    case k_comment: return Token::comment;
+    case k_string: return Token::string;
+    case k_variable: return Token::variable;
+    case k_preproc: return Token::preproc;
+    default: return Token::text;
+  }
+}
+
+Lexer const* find(std::string_view lang)
+{
+  std::string name {lang};
+
+  for (auto& c : name)
+  {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+
+  auto const it = std::lower_bound(names.begin(), names.end(), Name {name, nullptr});
+
+  if (it == names.end() || it->name != name)
+  {
+    return nullptr;
+  }
+
+  return it->lexer;
+}
+
+void line(Lexer const& lexer, std::uint8_t& state, std::string_view str, std::vector<Span>& spans)
+{
+  spans.clear();
+
+  auto cur = state == s_text ? std::uint8_t {s_bol} : state;
+  std::size_t begin {0};
+
+  // end the span of the kind of 'from' at 'end'
+  auto const emit = [&](std::uint8_t from, std::size_t end)
+  {
+    if (end > begin)
+    {
+      auto const span = str.substr(begin, end - begin);
+      spans.emplace_back(Span {token(lexer, state_kind[from], span), span});
+      begin = end;
+    }
+  };
+
+  for (std::size_t i = 0; i < str.size(); ++i)
+  {
+    auto const trans = lexer.table[cur][byte_class[static_cast<unsigned char>(str[i])]];
+
+    switch (trans.mode)
+    {
+      case m_close:
+      {
+        emit(cur, i + 1);
+        break;
+      }
+      case m_back:
+      {
+        emit(cur, i - 1);
+        break;
+      }
+      default:
+      {
+        if (state_kind[trans.next] != state_kind[cur])
+        {
+          emit(cur, i);
+        }
+
+        break;
+      }
+    }
+
+    cur = trans.next;
+  }
+
+  emit(cur, str.size());
+  state = lexer.eol[cur];
+}
+
+} // namespace OB::Stig::Highlight
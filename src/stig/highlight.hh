@@ -0,0 +1,46 @@
+#ifndef OB_STIG_HIGHLIGHT_HH
+#define OB_STIG_HIGHLIGHT_HH
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string_view>
+#include <vector>
+
+namespace OB::Stig::Highlight
+{
+
+enum class Token : std::uint8_t
+{
+  text,
+  keyword,
+  type,
+  string,
+  number,
+  comment,
+  preproc,
+  variable,
+}; // enum class Token
+
+struct Span
+{
+  Token token;
+  std::string_view str;
+}; // struct Span
+
+// a lexer for one language, a table of byte class transitions built at compile time
+struct Lexer;
+
+// get the lexer for the language named by a fenced code block, such as 'cpp', 'rs', or 'sh'
+// returns nullptr if the language is not known
+Lexer const* find(std::string_view lang);
+
+// split a line of code into spans of tokens in one pass over its bytes
+// 'state' carries comments and strings that continue onto the next line,
+// it starts at 0 for the first line of a block
+// the spans are views into 'str'
+void line(Lexer const& lexer, std::uint8_t& state, std::string_view str, std::vector<Span>& spans);
+
+} // namespace OB::Stig::Highlight
+
+#endif // OB_STIG_HIGHLIGHT_HH
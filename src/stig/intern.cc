@@ -0,0 +1,94 @@
+#include "stig/intern.hh"
+
+#include "stig/lang.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <string_view>
+#include <optional>
+#include <mutex>
+#include <shared_mutex>
+
+namespace OB::Stig::Intern
+{
+
+Entry Pool::add(std::string_view str)
+{
+  if (str.empty())
+  {
+    return {};
+  }
+
+  if (auto const found = find(str))
+  {
+    return *found;
+  }
+
+  auto* const data = static_cast<char*>(_arena.allocate(str.size(), 1));
+  std::memcpy(data, str.data(), str.size());
+
+  auto const id = static_cast<std::uint32_t>(_strs.size());
+  auto const& res = _strs.emplace_back(data, str.size());
+  _ids.emplace(res, id);
+
+  return {id, res};
+}
+
+std::optional<Entry> Pool::find(std::string_view str) const
+{
+  if (str.empty())
+  {
+    return Entry {};
+  }
+
+  if (auto const it = _ids.find(str); it != _ids.end())
+  {
+    return Entry {it->second, _strs[it->second]};
+  }
+
+  return {};
+}
+
+void add(Repo& repo)
+{
+  // most strings are already pooled, so lookups share the lock
+  // and only a string that is not there yet takes it alone
+  static std::shared_mutex mtx;
+  static Pool owners;
+  static Pool languages;
+
+  auto const intern = [](Pool& pool, std::string_view str)
+  {
+    {
+      std::shared_lock<std::shared_mutex> lock {mtx};
+
+      if (auto const found = pool.find(str))
+      {
+        return *found;
+      }
+    }
+
+    std::unique_lock<std::shared_mutex> lock {mtx};
+
+    return pool.add(str);
+  };
+
+  repo.owner = intern(owners, repo.owner).str;
+
+  // languages in the table are already stored once
+  if (auto const lang = Lang::id(repo.language))
+  {
+    repo.language = Lang::at(lang - 1).name;
+    repo.language_id = lang;
+  }
+  else if (! repo.language.empty())
+  {
+    auto const other = intern(languages, repo.language);
+    repo.language = other.str;
+    repo.language_id = static_cast<std::uint32_t>(Lang::size()) + other.id;
+  }
+}
+
+} // namespace OB::Stig::Intern
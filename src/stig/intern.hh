@@ -0,0 +1,74 @@
+#ifndef OB_STIG_INTERN_HH
+#define OB_STIG_INTERN_HH
+
+#include "stig/repo.hh"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <memory_resource>
+#include <unordered_map>
+
+namespace OB::Stig::Intern
+{
+
+struct Entry
+{
+  std::uint32_t id {0};
+
+  // the pooled copy of the string
+  std::string_view str;
+}; // struct Entry
+
+// stores each distinct string once and hands out 32-bit ids for them
+// id 0 is the empty string
+// strings and the nodes of the id map are bump allocated from an arena of blocks
+// that never move, so views of them live as long as the pool
+class Pool
+{
+public:
+
+  Pool() = default;
+
+  Pool(Pool const&) = delete;
+  Pool& operator=(Pool const&) = delete;
+
+  Entry add(std::string_view str);
+
+  // the entry of 'str' if it has been added, without adding it
+  std::optional<Entry> find(std::string_view str) const;
+
+  std::string_view str(std::uint32_t id) const
+  {
+    return id < _strs.size() ? _strs[id] : std::string_view();
+  }
+
+  // number of ids handed out, including the empty string
+  std::size_t size() const
+  {
+    return _strs.size();
+  }
+
+private:
+
+  // the first block, later ones grow from it
+  std::pmr::monotonic_buffer_resource _arena {64 * 1024};
+
+  std::vector<std::string_view> _strs {""};
+  std::pmr::unordered_map<std::string_view, std::uint32_t> _ids {&_arena};
+}; // class Pool
+
+// intern the owner and language of 'repo' in the pools shared by the process,
+// pointing them at the pooled strings so they no longer hold the buffer they were read from,
+// and setting the language id
+// language ids up to Lang::size() are positions in the language table, so they index
+// its precomputed colors, languages not in the table are numbered after it
+// safe to call from any thread
+void add(Repo& repo);
+
+} // namespace OB::Stig::Intern
+
+#endif // OB_STIG_INTERN_HH
@@ -1,253 +1,368 @@
 #include "stig/lang.hh"
 
+#include "ob/term.hh"
+namespace aec = OB::Term::ANSI_Escape_Codes;
+
+#include "ob/string.hh"
+namespace String = OB::String;
+
+#include <cstddef>
+#include <cstdint>
+
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
 
 namespace OB::Stig::Lang
 {
 
-std::unordered_map<std::string, std::string> const colors {
-  {"Mercury", "#ff2b2b"},
-  {"TypeScript", "#2b7489"},
-  {"PureBasic", "#5a6986"},
-  {"Objective-C++", "#6866fb"},
-  {"Self", "#0579aa"},
-  {"NewLisp", "#87AED7"},
-  {"Fortran", "#4d41b1"},
-  {"Jupyter Notebook", "#DA5B0B"},
-  {"Rebol", "#358a5b"},
-  {"Frege", "#00cafe"},
-  {"AspectJ", "#a957b0"},
-  {"Omgrofl", "#cabbff"},
-  {"Shell", "#89e051"},
-  {"HiveQL", "#dce200"},
-  {"AppleScript", "#101F1F"},
-  {"Eiffel", "#946d57"},
-  {"XQuery", "#5232e7"},
-  {"RAML", "#77d9fb"},
-  {"MTML", "#b7e1f4"},
-  {"Racket", "#22228f"},
-  {"Elixir", "#6e4a7e"},
-  {"SAS", "#B34936"},
-  {"MQL4", "#62A8D6"},
-  {"MQL5", "#4A76B8"},
+// language colors, sorted by name for binary search
+// stored as a constant table so no work is done at program startup
+constexpr std::array<Entry, 231> colors {{
+  {"1C Enterprise", "#814CCC"},
+  {"ABAP", "#E8274B"},
+  {"AGS Script", "#B9D9FF"},
+  {"AMPL", "#E6EFBB"},
+  {"ANTLR", "#9DC3FF"},
+  {"API Blueprint", "#2ACCA8"},
+  {"APL", "#5A8164"},
+  {"ASP", "#6a40fd"},
+  {"ATS", "#1ac620"},
+  {"ActionScript", "#882B0F"},
+  {"Ada", "#02f88c"},
   {"Agda", "#315665"},
-  {"wisp", "#7582D1"},
-  {"SRecode Template", "#348a34"},
-  {"D", "#ba595e"},
-  {"PowerBuilder", "#8f0f8d"},
-  {"Kotlin", "#F18E33"},
-  {"Opal", "#f7ede0"},
-  {"TI Program", "#A0AA87"},
-  {"Crystal", "#776791"},
-  {"Objective-C", "#438eff"},
+  {"Alloy", "#64C800"},
+  {"AngelScript", "#C7D7DC"},
+  {"AppleScript", "#101F1F"},
+  {"Arc", "#aa2afe"},
+  {"AspectJ", "#a957b0"},
+  {"Assembly", "#6E4C13"},
+  {"AutoHotkey", "#6594b9"},
+  {"AutoIt", "#1C3552"},
+  {"Ballerina", "#FF5000"},
   {"Batchfile", "#C1F12E"},
-  {"Oz", "#fab738"},
-  {"Mirah", "#c7a938"},
-  {"Objective-J", "#ff0c5a"},
-  {"Ragel", "#9d5200"},
-  {"Roff", "#ecdebe"},
-  {"FreeMarker", "#0050b2"},
-  {"Ruby", "#701516"},
-  {"Ceylon", "#dfa535"},
-  {"Component Pascal", "#B0CE4E"},
-  {"Nextflow", "#3ac486"},
+  {"BlitzMax", "#cd6400"},
+  {"Boo", "#d4bec1"},
   {"Brainfuck", "#2F2530"},
-  {"Nit", "#009917"},
-  {"APL", "#5A8164"},
-  {"Hack", "#878787"},
-  {"Go", "#375eab"},
-  {"Ring", "#2D54CB"},
-  {"PHP", "#4F5D95"},
+  {"C", "#555555"},
+  {"C#", "#178600"},
+  {"C++", "#f34b7d"},
+  {"CSS", "#563d7c"},
+  {"Ceylon", "#dfa535"},
+  {"Chapel", "#8dc63f"},
   {"Cirru", "#ccccff"},
-  {"SQF", "#3F3F3F"},
-  {"Glyph", "#c1ac7f"},
-  {"1C Enterprise", "#814CCC"},
-  {"WebAssembly", "#04133b"},
-  {"Java", "#b07219"},
-  {"MAXScript", "#00a6a6"},
-  {"Scala", "#c22d40"},
-  {"Makefile", "#427819"},
+  {"Clarion", "#db901e"},
+  {"Clean", "#3F85AF"},
+  {"Click", "#E4E6F3"},
+  {"Clojure", "#db5855"},
+  {"CoffeeScript", "#244776"},
   {"ColdFusion", "#ed2cd6"},
-  {"Perl", "#0298c3"},
-  {"Arc", "#aa2afe"},
-  {"sed", "#64b970"},
-  {"GDScript", "#355570"},
-  {"Verilog", "#b2b7f8"},
+  {"Common Lisp", "#3fb68b"},
+  {"Common Workflow Language", "#B5314C"},
+  {"Component Pascal", "#B0CE4E"},
+  {"Crystal", "#776791"},
+  {"Cuda", "#3A4E3A"},
+  {"D", "#ba595e"},
+  {"DM", "#447265"},
+  {"Dart", "#00B4AB"},
+  {"DataWeave", "#003a52"},
+  {"Dockerfile", "#0db7ed"},
+  {"Dogescript", "#cca760"},
+  {"Dylan", "#6c616e"},
+  {"E", "#ccce35"},
+  {"ECL", "#8a1267"},
+  {"EQ", "#a78649"},
+  {"Eiffel", "#946d57"},
+  {"Elixir", "#6e4a7e"},
+  {"Elm", "#60B5CC"},
+  {"Emacs Lisp", "#c065db"},
+  {"EmberScript", "#FFF4F3"},
+  {"Erlang", "#B83998"},
+  {"F#", "#b845fc"},
+  {"FLUX", "#88ccff"},
   {"Factor", "#636746"},
-  {"Haxe", "#df7900"},
+  {"Fancy", "#7b9db4"},
+  {"Fantom", "#14253c"},
   {"Forth", "#341708"},
-  {"Red", "#f50000"},
-  {"Hy", "#7790B2"},
-  {"Volt", "#1F1F1F"},
-  {"AngelScript", "#C7D7DC"},
-  {"LSL", "#3d9970"},
-  {"Max", "#c4a79c"},
-  {"eC", "#913960"},
-  {"Terra", "#00004c"},
-  {"CoffeeScript", "#244776"},
+  {"Fortran", "#4d41b1"},
+  {"FreeMarker", "#0050b2"},
+  {"Frege", "#00cafe"},
+  {"GDScript", "#355570"},
+  {"Game Maker Language", "#8fb200"},
+  {"Genie", "#fb855d"},
+  {"Gherkin", "#5B2063"},
+  {"Glyph", "#c1ac7f"},
+  {"Gnuplot", "#f0a9f0"},
+  {"Go", "#375eab"},
+  {"Golo", "#88562A"},
+  {"Gosu", "#82937f"},
+  {"Grammatical Framework", "#79aa7a"},
+  {"Groovy", "#e69f56"},
   {"HTML", "#e34c26"},
-  {"Lex", "#DBCA00"},
-  {"API Blueprint", "#2ACCA8"},
+  {"Hack", "#878787"},
+  {"Harbour", "#0e60e3"},
+  {"Haskell", "#5e5086"},
+  {"Haxe", "#df7900"},
+  {"HiveQL", "#dce200"},
+  {"Hy", "#7790B2"},
+  {"IDL", "#a3522f"},
   {"Idris", "#b30000"},
-  {"Swift", "#ffac45"},
-  {"Modula-3", "#223388"},
-  {"C", "#555555"},
-  {"AutoHotkey", "#6594b9"},
-  {"P4", "#7055b5"},
+  {"Io", "#a9188d"},
+  {"Ioke", "#078193"},
   {"Isabelle", "#FEFE00"},
-  {"Metal", "#8f14e9"},
-  {"Clarion", "#db901e"},
-  {"Vue", "#2c3e50"},
+  {"J", "#9EEDFF"},
   {"JSONiq", "#40d47e"},
-  {"Boo", "#d4bec1"},
-  {"AutoIt", "#1C3552"},
-  {"Genie", "#fb855d"},
-  {"Clojure", "#db5855"},
-  {"EQ", "#a78649"},
-  {"Visual Basic", "#945db7"},
-  {"Rust", "#dea584"},
-  {"Prolog", "#74283c"},
-  {"SourcePawn", "#5c7611"},
-  {"AMPL", "#E6EFBB"},
-  {"ANTLR", "#9DC3FF"},
-  {"wdl", "#42f1f4"},
-  {"Harbour", "#0e60e3"},
-  {"Yacc", "#4B6C4B"},
-  {"Tcl", "#e4cc98"},
-  {"Quake", "#882233"},
-  {"BlitzMax", "#cd6400"},
-  {"PigLatin", "#fcd7de"},
-  {"xBase", "#403a40"},
-  {"LLVM", "#185619"},
-  {"Lasso", "#999999"},
-  {"ECL", "#8a1267"},
-  {"VHDL", "#adb2cb"},
-  {"Elm", "#60B5CC"},
-  {"Propeller Spin", "#7fa2a7"},
-  {"Rascal", "#fffaa0"},
-  {"X10", "#4B6BEF"},
-  {"IDL", "#a3522f"},
-  {"ATS", "#1ac620"},
-  {"Ada", "#02f88c"},
-  {"Nu", "#c9df40"},
+  {"Java", "#b07219"},
+  {"JavaScript", "#f1e05a"},
+  {"Jolie", "#843179"},
+  {"Julia", "#a270ba"},
+  {"Jupyter Notebook", "#DA5B0B"},
+  {"KRL", "#28430A"},
+  {"Kotlin", "#F18E33"},
   {"LFE", "#4C3023"},
-  {"SuperCollider", "#46390b"},
-  {"Oxygene", "#cdd0e3"},
-  {"ASP", "#6a40fd"},
-  {"Assembly", "#6E4C13"},
-  {"Gnuplot", "#f0a9f0"},
-  {"NetLinx", "#0aa0ff"},
-  {"C#", "#178600"},
-  {"Turing", "#cf142b"},
-  {"Vala", "#fbe5cd"},
-  {"Processing", "#0096D8"},
-  {"FLUX", "#88ccff"},
-  {"Perl 6", "#0000fb"},
-  {"CSS", "#563d7c"},
-  {"Emacs Lisp", "#c065db"},
-  {"Stan", "#b2011d"},
-  {"SaltStack", "#646464"},
-  {"Gherkin", "#5B2063"},
-  {"QML", "#44a51c"},
-  {"Pike", "#005390"},
-  {"DataWeave", "#003a52"},
+  {"LLVM", "#185619"},
   {"LOLCODE", "#cc9900"},
-  {"ooc", "#b0b77e"},
-  {"XSLT", "#EB8CEB"},
-  {"XC", "#99DA07"},
-  {"J", "#9EEDFF"},
+  {"LSL", "#3d9970"},
+  {"Lasso", "#999999"},
+  {"Lex", "#DBCA00"},
+  {"LiveScript", "#499886"},
+  {"LookML", "#652B81"},
+  {"Lua", "#000080"},
+  {"MAXScript", "#00a6a6"},
+  {"MQL4", "#62A8D6"},
+  {"MQL5", "#4A76B8"},
+  {"MTML", "#b7e1f4"},
+  {"Makefile", "#427819"},
   {"Mask", "#f97732"},
-  {"EmberScript", "#FFF4F3"},
-  {"TeX", "#3D6117"},
-  {"Pep8", "#C76F5B"},
+  {"Matlab", "#e16737"},
+  {"Max", "#c4a79c"},
+  {"Mercury", "#ff2b2b"},
+  {"Meson", "#007800"},
+  {"Metal", "#8f14e9"},
+  {"Mirah", "#c7a938"},
+  {"Modula-3", "#223388"},
+  {"NCL", "#28431f"},
+  {"Nearley", "#990000"},
   {"Nemerle", "#3d3c6e"},
-  {"Cuda", "#3A4E3A"},
-  {"KRL", "#28430A"},
-  {"Vim script", "#199f4b"},
-  {"Ren'Py", "#ff7f7f"},
-  {"Golo", "#88562A"},
-  {"Lua", "#000080"},
+  {"NetLinx", "#0aa0ff"},
+  {"NetLinx+ERB", "#747faa"},
+  {"NetLogo", "#ff6375"},
+  {"NewLisp", "#87AED7"},
+  {"Nextflow", "#3ac486"},
+  {"Nim", "#37775b"},
+  {"Nit", "#009917"},
+  {"Nix", "#7e7eff"},
+  {"Nu", "#c9df40"},
   {"OCaml", "#3be133"},
-  {"Shen", "#120F14"},
+  {"Objective-C", "#438eff"},
+  {"Objective-C++", "#6866fb"},
+  {"Objective-J", "#ff0c5a"},
+  {"Omgrofl", "#cabbff"},
+  {"Opal", "#f7ede0"},
+  {"Oxygene", "#cdd0e3"},
+  {"Oz", "#fab738"},
+  {"P4", "#7055b5"},
+  {"PAWN", "#dbb284"},
+  {"PHP", "#4F5D95"},
+  {"PLSQL", "#dad8d8"},
+  {"Pan", "#cc0000"},
+  {"Papyrus", "#6600cc"},
+  {"Parrot", "#f3ca0a"},
   {"Pascal", "#E3F171"},
-  {"F#", "#b845fc"},
-  {"Puppet", "#302B6D"},
-  {"ActionScript", "#882B0F"},
-  {"Fantom", "#14253c"},
-  {"Zephir", "#118f9e"},
-  {"Click", "#E4E6F3"},
-  {"Smalltalk", "#596706"},
-  {"Matlab", "#e16737"},
-  {"Ballerina", "#FF5000"},
-  {"DM", "#447265"},
-  {"Ioke", "#078193"},
+  {"Pep8", "#C76F5B"},
+  {"Perl", "#0298c3"},
+  {"Perl 6", "#0000fb"},
+  {"PigLatin", "#fcd7de"},
+  {"Pike", "#005390"},
   {"PogoScript", "#d80074"},
-  {"LiveScript", "#499886"},
-  {"JavaScript", "#f1e05a"},
-  {"ABAP", "#E8274B"},
-  {"Julia", "#a270ba"},
-  {"Slash", "#007eff"},
   {"PostScript", "#da291c"},
+  {"PowerBuilder", "#8f0f8d"},
+  {"PowerShell", "#012456"},
+  {"Processing", "#0096D8"},
+  {"Prolog", "#74283c"},
+  {"Propeller Spin", "#7fa2a7"},
+  {"Puppet", "#302B6D"},
+  {"PureBasic", "#5a6986"},
+  {"PureScript", "#1D222D"},
+  {"Python", "#3572A5"},
+  {"QML", "#44a51c"},
+  {"Quake", "#882233"},
   {"R", "#198CE7"},
-  {"Erlang", "#B83998"},
-  {"Pan", "#cc0000"},
-  {"LookML", "#652B81"},
+  {"RAML", "#77d9fb"},
+  {"RUNOFF", "#665a4e"},
+  {"Racket", "#22228f"},
+  {"Ragel", "#9d5200"},
+  {"Rascal", "#fffaa0"},
+  {"Rebol", "#358a5b"},
+  {"Red", "#f50000"},
+  {"Ren'Py", "#ff7f7f"},
+  {"Ring", "#2D54CB"},
+  {"Roff", "#ecdebe"},
+  {"Rouge", "#cc0088"},
+  {"Ruby", "#701516"},
+  {"Rust", "#dea584"},
+  {"SAS", "#B34936"},
+  {"SQF", "#3F3F3F"},
+  {"SRecode Template", "#348a34"},
+  {"SaltStack", "#646464"},
+  {"Scala", "#c22d40"},
   {"Scheme", "#1e4aec"},
-  {"Squirrel", "#800000"},
-  {"Nim", "#37775b"},
-  {"Python", "#3572A5"},
-  {"Dockerfile", "#0db7ed"},
+  {"Self", "#0579aa"},
+  {"Shell", "#89e051"},
+  {"Shen", "#120F14"},
+  {"Slash", "#007eff"},
+  {"Smalltalk", "#596706"},
   {"Solidity", "#AA6746"},
-  {"Common Lisp", "#3fb68b"},
-  {"Dart", "#00B4AB"},
-  {"Nix", "#7e7eff"},
-  {"Nearley", "#990000"},
+  {"SourcePawn", "#5c7611"},
+  {"Squirrel", "#800000"},
+  {"Stan", "#b2011d"},
+  {"Standard ML", "#dc566d"},
+  {"SuperCollider", "#46390b"},
+  {"Swift", "#ffac45"},
   {"SystemVerilog", "#DAE1C2"},
-  {"Chapel", "#8dc63f"},
-  {"Groovy", "#e69f56"},
-  {"Dylan", "#6c616e"},
-  {"E", "#ccce35"},
-  {"Parrot", "#f3ca0a"},
-  {"Grammatical Framework", "#79aa7a"},
-  {"Game Maker Language", "#8fb200"},
-  {"VCL", "#148AA8"},
-  {"Papyrus", "#6600cc"},
-  {"C++", "#f34b7d"},
-  {"NetLinx+ERB", "#747faa"},
-  {"Common Workflow Language", "#B5314C"},
-  {"Clean", "#3F85AF"},
-  {"Alloy", "#64C800"},
-  {"Jolie", "#843179"},
-  {"Gosu", "#82937f"},
-  {"PLSQL", "#dad8d8"},
-  {"PAWN", "#dbb284"},
+  {"TI Program", "#A0AA87"},
+  {"Tcl", "#e4cc98"},
+  {"TeX", "#3D6117"},
+  {"Terra", "#00004c"},
+  {"Turing", "#cf142b"},
+  {"TypeScript", "#2b7489"},
   {"UnrealScript", "#a54c4d"},
-  {"Standard ML", "#dc566d"},
-  {"PureScript", "#1D222D"},
-  {"Fancy", "#7b9db4"},
+  {"VCL", "#148AA8"},
+  {"VHDL", "#adb2cb"},
+  {"Vala", "#fbe5cd"},
+  {"Verilog", "#b2b7f8"},
+  {"Vim script", "#199f4b"},
+  {"Visual Basic", "#945db7"},
+  {"Volt", "#1F1F1F"},
+  {"Vue", "#2c3e50"},
+  {"WebAssembly", "#04133b"},
+  {"X10", "#4B6BEF"},
+  {"XC", "#99DA07"},
+  {"XQuery", "#5232e7"},
+  {"XSLT", "#EB8CEB"},
+  {"Yacc", "#4B6C4B"},
+  {"Zephir", "#118f9e"},
+  {"eC", "#913960"},
   {"nesC", "#94B0C7"},
+  {"ooc", "#b0b77e"},
   {"q", "#0040cd"},
-  {"Haskell", "#5e5086"},
-  {"NCL", "#28431f"},
-  {"Io", "#a9188d"},
-  {"Rouge", "#cc0088"},
-  {"RUNOFF", "#665a4e"},
-  {"NetLogo", "#ff6375"},
-  {"AGS Script", "#B9D9FF"},
-  {"Meson", "#007800"},
-  {"Dogescript", "#cca760"},
-  {"PowerShell", "#012456"},
-};
+  {"sed", "#64b970"},
+  {"wdl", "#42f1f4"},
+  {"wisp", "#7582D1"},
+  {"xBase", "#403a40"},
+}};
+
+constexpr bool is_sorted()
+{
+  for (std::size_t i = 1; i < colors.size(); ++i)
+  {
+    if (! (colors[i - 1].name < colors[i].name))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static_assert(is_sorted(), "language colors must be sorted by name");
+
+std::uint32_t id(std::string_view lang)
+{
+  auto const it = std::lower_bound(colors.begin(), colors.end(), lang,
+    [](Entry const& lhs, std::string_view rhs) {
+      return lhs.name < rhs;
+    });
+
+  if (it == colors.end() || it->name != lang)
+  {
+    return 0;
+  }
+
+  return static_cast<std::uint32_t>(it - colors.begin()) + 1;
+}
 
-std::string color(std::string const& lang)
+std::string_view color(std::uint32_t id)
 {
-  if (colors.find(lang) == colors.end())
+  if (id == 0 || id > colors.size())
   {
     return "#ccc";
   }
 
-  return colors.at(lang);
+  return colors[id - 1].color;
+}
+
+std::string const& escape(std::uint32_t id)
+{
+  // the last entry is the default color
+  static std::vector<std::string> const codes {[]
+  {
+    std::vector<std::string> res;
+    res.reserve(colors.size() + 1);
+
+    for (std::uint32_t i = 1; i <= colors.size() + 1; ++i)
+    {
+      res.emplace_back(aec::fg_true(std::string(color(i))));
+    }
+
+    return res;
+  }()};
+
+  if (id == 0 || id > colors.size())
+  {
+    return codes.back();
+  }
+
+  return codes[id - 1];
+}
+
+std::size_t size()
+{
+  return colors.size();
+}
+
+Entry const& at(std::size_t pos)
+{
+  return colors.at(pos);
+}
+
+std::string qualifier(std::string_view name)
+{
+  auto res = String::lower(name);
+  std::replace(res.begin(), res.end(), ' ', '-');
+
+  return res;
+}
+
+std::string_view alias(std::string_view value)
+{
+  static constexpr std::array<std::pair<std::string_view, std::string_view>, 12> aliases {{
+    {"bash", "shell"},
+    {"cpp", "c++"},
+    {"csharp", "c#"},
+    {"golang", "go"},
+    {"js", "javascript"},
+    {"objc", "objective-c"},
+    {"py", "python"},
+    {"rb", "ruby"},
+    {"rs", "rust"},
+    {"sh", "shell"},
+    {"ts", "typescript"},
+    {"yml", "yaml"},
+  }};
+
+  for (auto const& [key, name] : aliases)
+  {
+    if (value == key)
+    {
+      return name;
+    }
+  }
+
+  return value;
 }
 
 } // namespace OB::Stig::Lang
@@ -1,12 +1,45 @@
 #ifndef OB_STIG_LANG_HH
 #define OB_STIG_LANG_HH
 
+#include <cstddef>
+#include <cstdint>
+
 #include <string>
+#include <string_view>
 
 namespace OB::Stig::Lang
 {
 
-std::string color(std::string const& lang);
+struct Entry
+{
+  std::string_view name;
+  std::string_view color;
+}; // struct Entry
+
+// get the id of a language, its position in the table plus one, or 0 if it is not in the table
+std::uint32_t id(std::string_view lang);
+
+// get the color of a language id as '#rrggbb'
+// 0 and ids past the table get a default color
+std::string_view color(std::uint32_t id);
+
+// get the escape code that sets the foreground to the color of a language id
+// built once for every id, so rendering a repo does no color work
+std::string const& escape(std::uint32_t id);
+
+// number of known languages
+std::size_t size();
+
+// get a language by its position in the table, sorted by name
+Entry const& at(std::size_t pos);
+
+// format a language name the way the 'language:' qualifier writes it,
+// lower case with dashes for spaces
+std::string qualifier(std::string_view name);
+
+// get the qualifier value that a common alias accepted by GitHub stands for,
+// such as 'c++' for 'cpp', or 'value' if it is not an alias
+std::string_view alias(std::string_view value);
 
 } // namespace OB::Stig::Lang
 
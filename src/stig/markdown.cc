@@ -0,0 +1,1604 @@
+#include "stig/markdown.hh"
+
+#include "ob/term.hh"
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <utility>
+#include <optional>
+#include <charconv>
+#include <algorithm>
+
+namespace OB::Stig::Markdown
+{
+
+namespace aec = OB::Term::ANSI_Escape_Codes;
+
+// leading whitespace of a line, tabs advance to the next multiple of 4 columns
+struct Indent
+{
+  std::size_t cols {0};
+  std::size_t bytes {0};
+}; // struct Indent
+
+struct Fence
+{
+  char c {0};
+  std::size_t len {0};
+  std::string_view info;
+}; // struct Fence
+
+struct Item
+{
+  // the marker as written, such as '-' or '12.'
+  std::string_view marker;
+
+  // columns from the marker to the item content
+  std::size_t width {0};
+
+  // bytes from the marker to the item content
+  std::size_t bytes {0};
+
+  bool ordered {false};
+}; // struct Item
+
+// prototypes
+bool is_space(char c);
+bool is_punct(char c);
+bool is_blank(std::string_view str);
+Indent indent(std::string_view str);
+std::string_view strip(std::string_view str, std::size_t cols);
+std::string_view trim(std::string_view str);
+std::size_t run(std::string_view str, std::size_t pos, char c);
+std::size_t cols(std::string_view str);
+bool is_rule(std::string_view str);
+std::size_t atx_level(std::string_view str);
+std::string_view atx_text(std::string_view str, std::size_t level);
+std::size_t setext_level(std::string_view str);
+std::optional<Fence> fence_open(std::string_view str);
+std::optional<Item> list_item(std::string_view str);
+bool is_html(std::string_view str);
+bool is_refdef(std::string_view str);
+bool starts_block(std::string_view str);
+std::string const& token_style(Highlight::Token token);
+bool closer(std::string_view str, std::size_t pos, char c, std::size_t len);
+void utf8(std::string& out, std::uint32_t cp);
+std::size_t entity(std::string_view str, std::string& out);
+
+bool is_space(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n';
+}
+
+bool is_punct(char c)
+{
+  return std::ispunct(static_cast<unsigned char>(c));
+}
+
+bool is_blank(std::string_view str)
+{
+  return str.find_first_not_of(" \t") == std::string_view::npos;
+}
+
+Indent indent(std::string_view str)
+{
+  Indent res;
+
+  for (; res.bytes < str.size(); ++res.bytes)
+  {
+    if (str[res.bytes] == ' ')
+    {
+      ++res.cols;
+    }
+    else if (str[res.bytes] == '\t')
+    {
+      res.cols += 4 - res.cols % 4;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  return res;
+}
+
+// remove up to 'cols' columns of leading whitespace
+std::string_view strip(std::string_view str, std::size_t cols)
+{
+  std::size_t col {0};
+  std::size_t i {0};
+
+  for (; i < str.size() && col < cols; ++i)
+  {
+    if (str[i] == ' ')
+    {
+      ++col;
+    }
+    else if (str[i] == '\t')
+    {
+      col += 4 - col % 4;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  return str.substr(i);
+}
+
+std::string_view trim(std::string_view str)
+{
+  auto const begin = str.find_first_not_of(" \t");
+
+  if (begin == std::string_view::npos)
+  {
+    return {};
+  }
+
+  return str.substr(begin, str.find_last_not_of(" \t") - begin + 1);
+}
+
+// the number of 'c' in a row from 'pos'
+std::size_t run(std::string_view str, std::size_t pos, char c)
+{
+  auto const end = str.find_first_not_of(c, pos);
+
+  return (end == std::string_view::npos ? str.size() : end) - pos;
+}
+
+// the number of code points
+std::size_t cols(std::string_view str)
+{
+  return static_cast<std::size_t>(std::count_if(str.begin(), str.end(),
+    [](char c) { return (static_cast<unsigned char>(c) & 0xc0) != 0x80; }));
+}
+
+// three or more of '*', '-', or '_' with optional spaces
+bool is_rule(std::string_view str)
+{
+  if (str.empty() || (str.front() != '*' && str.front() != '-' && str.front() != '_'))
+  {
+    return false;
+  }
+
+  std::size_t n {0};
+
+  for (auto const c : str)
+  {
+    if (c == str.front())
+    {
+      ++n;
+    }
+    else if (c != ' ' && c != '\t')
+    {
+      return false;
+    }
+  }
+
+  return n >= 3;
+}
+
+std::size_t atx_level(std::string_view str)
+{
+  auto const n = run(str, 0, '#');
+
+  if (n == 0 || n > 6 || (n < str.size() && str[n] != ' ' && str[n] != '\t'))
+  {
+    return 0;
+  }
+
+  return n;
+}
+
+std::string_view atx_text(std::string_view str, std::size_t level)
+{
+  auto res = trim(str.substr(level));
+
+  // drop the optional closing sequence
+  auto const pos = res.find_last_not_of('#');
+
+  if (pos == std::string_view::npos)
+  {
+    return {};
+  }
+
+  if (pos + 1 < res.size() && (res[pos] == ' ' || res[pos] == '\t'))
+  {
+    res = trim(res.substr(0, pos));
+  }
+
+  return res;
+}
+
+std::size_t setext_level(std::string_view str)
+{
+  auto const line = trim(str);
+
+  if (line.empty())
+  {
+    return 0;
+  }
+
+  if (run(line, 0, '=') == line.size())
+  {
+    return 1;
+  }
+
+  if (run(line, 0, '-') == line.size())
+  {
+    return 2;
+  }
+
+  return 0;
+}
+
+std::optional<Fence> fence_open(std::string_view str)
+{
+  if (str.empty() || (str.front() != '`' && str.front() != '~'))
+  {
+    return {};
+  }
+
+  Fence res;
+  res.c = str.front();
+  res.len = run(str, 0, res.c);
+  res.info = trim(str.substr(res.len));
+
+  if (res.len < 3 || (res.c == '`' && res.info.find('`') != std::string_view::npos))
+  {
+    return {};
+  }
+
+  return res;
+}
+
+std::optional<Item> list_item(std::string_view str)
+{
+  std::size_t n {0};
+
+  if (! str.empty() && (str.front() == '-' || str.front() == '+' || str.front() == '*'))
+  {
+    n = 1;
+  }
+  else
+  {
+    while (n < str.size() && n < 9 && std::isdigit(static_cast<unsigned char>(str[n])))
+    {
+      ++n;
+    }
+
+    if (n == 0 || n >= str.size() || (str[n] != '.' && str[n] != ')'))
+    {
+      return {};
+    }
+
+    ++n;
+  }
+
+  if (n < str.size() && str[n] != ' ' && str[n] != '\t')
+  {
+    return {};
+  }
+
+  Item res;
+  res.marker = str.substr(0, n);
+  res.ordered = std::isdigit(static_cast<unsigned char>(str.front()));
+
+  auto const space = indent(str.substr(n));
+
+  if (n + space.bytes == str.size())
+  {
+    // an empty item
+    res.width = n + 1;
+    res.bytes = str.size();
+  }
+  else if (space.cols > 4)
+  {
+    // the content is an indented code block
+    res.width = n + 1;
+    res.bytes = n + 1;
+  }
+  else
+  {
+    res.width = n + space.cols;
+    res.bytes = n + space.bytes;
+  }
+
+  return res;
+}
+
+bool is_html(std::string_view str)
+{
+  return str.size() > 1 && str.front() == '<' &&
+    (std::isalpha(static_cast<unsigned char>(str[1])) || str[1] == '/' || str[1] == '!');
+}
+
+// a link reference definition, '[label]: url'
+bool is_refdef(std::string_view str)
+{
+  if (str.size() < 4 || str.front() != '[' || str[1] == '^')
+  {
+    return false;
+  }
+
+  auto const end = str.find("]:");
+
+  return end != std::string_view::npos && end > 1 &&
+    str.substr(1, end - 1).find_first_of("[]") == std::string_view::npos;
+}
+
+// can the line interrupt a paragraph
+bool starts_block(std::string_view str)
+{
+  auto const ind = indent(str);
+
+  if (ind.cols >= 4)
+  {
+    return false;
+  }
+
+  auto const line = str.substr(ind.bytes);
+
+  if (line.empty())
+  {
+    return true;
+  }
+
+  if (is_rule(line) || atx_level(line) || fence_open(line) || is_html(line) ||
+    line.front() == '>' || line.front() == '|')
+  {
+    return true;
+  }
+
+  // an empty item can not interrupt a paragraph
+  auto const item = list_item(line);
+
+  return item && item->bytes < line.size();
+}
+
+std::string const& token_style(Highlight::Token token)
+{
+  static std::string const none;
+
+  switch (token)
+  {
+    case Highlight::Token::keyword: return aec::fg_magenta;
+    case Highlight::Token::type: return aec::fg_cyan;
+    case Highlight::Token::string: return aec::fg_green;
+    case Highlight::Token::number: return aec::fg_yellow;
+    case Highlight::Token::comment: return aec::dim;
+    case Highlight::Token::preproc: return aec::fg_blue;
+    case Highlight::Token::variable: return aec::fg_cyan;
+    default: return none;
+  }
+}
+
+// is there a run of at least 'len' 'c' after 'pos' that can close an emphasis
+bool closer(std::string_view str, std::size_t pos, char c, std::size_t len)
+{
+  for (auto i = str.find(c, pos); i != std::string_view::npos; i = str.find(c, i))
+  {
+    auto const n = run(str, i, c);
+    auto const prev = str[i - 1];
+    auto const next = i + n < str.size() ? str[i + n] : ' ';
+
+    bool const left {! is_space(next) && (! is_punct(next) || is_space(prev) || is_punct(prev))};
+    bool const right {! is_space(prev) && (! is_punct(prev) || is_space(next) || is_punct(next))};
+
+    if (n >= len && right && (c != '_' || ! left || is_punct(next)))
+    {
+      return true;
+    }
+
+    i += n;
+  }
+
+  return false;
+}
+
+void utf8(std::string& out, std::uint32_t cp)
+{
+  if (cp < 0x80)
+  {
+    out += static_cast<char>(cp);
+  }
+  else if (cp < 0x800)
+  {
+    out += static_cast<char>(0xc0 | (cp >> 6));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  }
+  else if (cp < 0x10000)
+  {
+    out += static_cast<char>(0xe0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  }
+  else
+  {
+    out += static_cast<char>(0xf0 | (cp >> 18));
+    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  }
+}
+
+// decode the entity at the start of 'str' into 'out'
+// returns the length of the entity, or 0 if it is not one
+std::size_t entity(std::string_view str, std::string& out)
+{
+  std::array<std::pair<std::string_view, std::string_view>, 15> constexpr names {{
+    {"amp", "&"},
+    {"lt", "<"},
+    {"gt", ">"},
+    {"quot", "\""},
+    {"apos", "'"},
+    {"nbsp", " "},
+    {"copy", "©"},
+    {"reg", "®"},
+    {"trade", "™"},
+    {"mdash", "—"},
+    {"ndash", "–"},
+    {"hellip", "…"},
+    {"middot", "·"},
+    {"larr", "←"},
+    {"rarr", "→"},
+  }};
+
+  auto const end = str.find(';');
+
+  if (end == std::string_view::npos || end < 2 || end > 10)
+  {
+    return 0;
+  }
+
+  auto name = str.substr(1, end - 1);
+  out.clear();
+
+  if (name.front() == '#')
+  {
+    name.remove_prefix(1);
+    int base {10};
+
+    if (! name.empty() && (name.front() == 'x' || name.front() == 'X'))
+    {
+      name.remove_prefix(1);
+      base = 16;
+    }
+
+    std::uint32_t cp {0};
+    auto const res = std::from_chars(name.data(), name.data() + name.size(), cp, base);
+
+    if (name.empty() || res.ec != std::errc() || res.ptr != name.data() + name.size() ||
+      cp == 0 || cp > 0x10ffff)
+    {
+      return 0;
+    }
+
+    utf8(out, cp);
+
+    return end + 1;
+  }
+
+  for (auto const& [key, val] : names)
+  {
+    if (key == name)
+    {
+      out = val;
+
+      return end + 1;
+    }
+  }
+
+  return 0;
+}
+
+Renderer::Renderer(std::ostream& os, std::size_t width) :
+  _os {os},
+  _width {width}
+{
+  _os.indent(2);
+  _os.white_space(false);
+
+  if (_width)
+  {
+    _os.width(_width);
+  }
+  else
+  {
+    _os.line_wrap(false);
+  }
+}
+
+void Renderer::feed(std::string_view str)
+{
+  while (! str.empty())
+  {
+    auto const end = str.find('\n');
+
+    if (end == std::string_view::npos)
+    {
+      _line += str;
+
+      return;
+    }
+
+    if (_line.empty())
+    {
+      line(str.substr(0, end));
+    }
+    else
+    {
+      _line += str.substr(0, end);
+      line(_line);
+      _line.clear();
+    }
+
+    str.remove_prefix(end + 1);
+  }
+}
+
+void Renderer::finish()
+{
+  if (! _line.empty())
+  {
+    line(_line);
+    _line.clear();
+  }
+
+  close();
+  bare();
+  _os.flush();
+}
+
+void Renderer::line(std::string_view str)
+{
+  if (! str.empty() && str.back() == '\r')
+  {
+    str.remove_suffix(1);
+  }
+
+  // inside code only the markers of the enclosing quotes are stripped
+  bool const in_code {_block == Block::fence || _block == Block::code};
+  std::size_t quote {0};
+
+  while (! in_code || quote < _quote)
+  {
+    auto const ind = indent(str);
+
+    if (ind.cols > 3 || ind.bytes >= str.size() || str[ind.bytes] != '>')
+    {
+      break;
+    }
+
+    str.remove_prefix(ind.bytes + 1);
+
+    if (! str.empty() && (str.front() == ' ' || str.front() == '\t'))
+    {
+      str.remove_prefix(1);
+    }
+
+    ++quote;
+  }
+
+  if (quote != _quote)
+  {
+    // a line without the markers continues the paragraph of the quote
+    if (quote < _quote && _block == Block::paragraph && ! starts_block(str))
+    {
+      para(str);
+
+      return;
+    }
+
+    close();
+    bare();
+    _lists.clear();
+    _quote = quote;
+  }
+
+  if (is_blank(str))
+  {
+    blank();
+
+    return;
+  }
+
+  // the innermost list item the line is indented into
+  auto const ind = indent(str);
+  std::size_t depth {0};
+
+  while (depth < _lists.size() && ind.cols >= _lists.at(depth).content)
+  {
+    ++depth;
+  }
+
+  auto const base = depth ? _lists.at(depth - 1).content : 0;
+  auto line = strip(str, base);
+
+  if (_block == Block::fence || _block == Block::code)
+  {
+    if (depth == _lists.size())
+    {
+      auto const code_ind = indent(line);
+
+      if (_block == Block::fence)
+      {
+        auto const rest = line.substr(code_ind.bytes);
+        auto const n = run(rest, 0, _fence_char);
+
+        if (code_ind.cols < 4 && n >= _fence_len && is_blank(rest.substr(n)))
+        {
+          close();
+        }
+        else
+        {
+          code(strip(line, _fence_indent));
+        }
+
+        return;
+      }
+
+      if (code_ind.cols >= 4)
+      {
+        for (; _code_blank; --_code_blank)
+        {
+          code({});
+        }
+
+        code(strip(line, 4));
+
+        return;
+      }
+    }
+
+    close();
+  }
+
+  auto const item_ind = indent(line);
+  auto const rest = line.substr(item_ind.bytes);
+  std::optional<Item> item;
+
+  if (item_ind.cols < 4 && ! is_rule(rest))
+  {
+    item = list_item(rest);
+  }
+
+  if (item)
+  {
+    std::array<char const*, 3> constexpr bullets {{"•", "◦", "▪"}};
+
+    close();
+    bare();
+    _lists.resize(depth);
+    _lists.emplace_back(List {base + item_ind.cols + item->width});
+
+    if (item->ordered)
+    {
+      _marker = item->marker;
+    }
+    else
+    {
+      _marker = bullets.at((_lists.size() - 1) % bullets.size());
+    }
+
+    line = rest.substr(item->bytes);
+
+    if (is_blank(line))
+    {
+      return;
+    }
+  }
+  else if (depth < _lists.size())
+  {
+    // a line that is not indented into the item continues its paragraph or ends the list
+    if (_block == Block::paragraph && ! starts_block(line))
+    {
+      para(line);
+
+      return;
+    }
+
+    close();
+    bare();
+    _lists.resize(depth);
+  }
+
+  leaf(line);
+}
+
+void Renderer::leaf(std::string_view str)
+{
+  auto const ind = indent(str);
+  auto const line = str.substr(ind.bytes);
+
+  if (_block == Block::html)
+  {
+    raw(line);
+
+    return;
+  }
+
+  if (ind.cols >= 4)
+  {
+    if (_block == Block::paragraph)
+    {
+      para(line);
+
+      return;
+    }
+
+    close();
+    begin();
+    margin();
+    pre(true);
+    _block = Block::code;
+    _lexer = nullptr;
+    code(strip(str, 4));
+
+    return;
+  }
+
+  if (_block == Block::paragraph)
+  {
+    if (auto const level = setext_level(line))
+    {
+      _block = Block::none;
+      heading(level, _para);
+      _para.clear();
+
+      return;
+    }
+  }
+
+  if (is_rule(line))
+  {
+    close();
+    rule();
+
+    return;
+  }
+
+  if (auto const level = atx_level(line))
+  {
+    close();
+    heading(level, atx_text(line, level));
+
+    return;
+  }
+
+  if (auto const fence = fence_open(line))
+  {
+    close();
+    begin();
+    margin();
+    pre(true);
+    _block = Block::fence;
+    _fence_char = fence->c;
+    _fence_len = fence->len;
+    _fence_indent = ind.cols;
+    _lang = fence->info.substr(0, fence->info.find_first_of(" \t{,"));
+    _lexer = Highlight::find(_lang);
+    _lex_state = 0;
+
+    return;
+  }
+
+  if (_block != Block::paragraph && is_html(line))
+  {
+    close();
+    begin();
+    margin();
+    _block = Block::html;
+    raw(line);
+
+    return;
+  }
+
+  if (line.front() == '|')
+  {
+    if (_block != Block::table)
+    {
+      close();
+      begin();
+      margin();
+      pre(true);
+      _block = Block::table;
+      _rows = 0;
+    }
+
+    row(line);
+
+    return;
+  }
+
+  if (_block == Block::paragraph)
+  {
+    para(line);
+
+    return;
+  }
+
+  close();
+
+  // link reference definitions are not shown
+  if (is_refdef(line))
+  {
+    return;
+  }
+
+  _block = Block::paragraph;
+  _para = line;
+}
+
+// continue the open paragraph with 'str'
+void Renderer::para(std::string_view str)
+{
+  _para += '\n';
+  _para += str.substr(indent(str).bytes);
+}
+
+void Renderer::blank()
+{
+  switch (_block)
+  {
+    case Block::fence:
+    {
+      code({});
+      break;
+    }
+    case Block::code:
+    {
+      ++_code_blank;
+      break;
+    }
+    default:
+    {
+      close();
+      _blank = true;
+      break;
+    }
+  }
+}
+
+// end the open block, writing it if it is a paragraph
+void Renderer::close()
+{
+  switch (_block)
+  {
+    case Block::paragraph:
+    {
+      begin();
+      margin();
+
+      if (_quote)
+      {
+        _base = aec::italic;
+      }
+
+      pen();
+      inlines(_para);
+      end();
+      _para.clear();
+      break;
+    }
+    case Block::code:
+    {
+      _blank = _code_blank != 0;
+      _code_blank = 0;
+      pre(false);
+      break;
+    }
+    case Block::fence:
+    case Block::table:
+    {
+      pre(false);
+      break;
+    }
+    default:
+    {
+      break;
+    }
+  }
+
+  _block = Block::none;
+}
+
+// write the marker of a list item that has no content
+void Renderer::bare()
+{
+  if (_marker.empty())
+  {
+    return;
+  }
+
+  begin();
+  margin();
+  end();
+}
+
+// separate the next block from the last one
+// blocks inside a list are only separated where the input had a blank line
+void Renderer::begin()
+{
+  bool const tight {! _lists.empty() && _in_list && ! _blank};
+
+  if (_wrote && ! tight)
+  {
+    _os.level(0).hang(0);
+    _os << "\n";
+  }
+
+  _wrote = true;
+  _blank = false;
+  _in_list = ! _lists.empty();
+}
+
+// indent the next block, writing the pending list marker
+void Renderer::margin()
+{
+  auto const level = _quote + _lists.size();
+
+  if (_marker.empty())
+  {
+    _os.level(level).hang(0);
+
+    return;
+  }
+
+  // wrapped lines of the item line up with its content
+  _os.level(level - 1).hang(cols(_marker) + 1);
+  _os << aec::reset << aec::bold << _marker << aec::reset << " ";
+  _marker.clear();
+}
+
+// set the style for the block and the open inline spans
+void Renderer::pen()
+{
+  _os << aec::reset << _base;
+
+  if (_strong)
+  {
+    _os << aec::bold;
+  }
+
+  if (_em)
+  {
+    _os << aec::italic;
+  }
+
+  if (_strike)
+  {
+    _os << aec::cross;
+  }
+
+  if (_link)
+  {
+    _os << aec::fg_cyan << aec::underline;
+  }
+
+  if (_code)
+  {
+    _os << aec::fg_green;
+  }
+}
+
+// end the line and close any inline spans left open
+void Renderer::end()
+{
+  _strong = 0;
+  _em = 0;
+  _strike = false;
+  _link = false;
+  _code = false;
+  _base.clear();
+
+  _os << aec::reset << "\n";
+}
+
+// preformatted text is not wrapped and keeps its whitespace
+void Renderer::pre(bool val)
+{
+  _os.line_wrap(! val && _width);
+  _os.white_space(val);
+}
+
+// write 'str' with the control characters removed
+void Renderer::text(std::string_view str)
+{
+  _buf.clear();
+
+  for (auto const c : str)
+  {
+    if (c == '\t')
+    {
+      _buf += ' ';
+    }
+    else if (static_cast<unsigned char>(c) >= 0x20 && c != 0x7f)
+    {
+      _buf += c;
+    }
+  }
+
+  _os.write(_buf.data(), static_cast<std::streamsize>(_buf.size()));
+}
+
+void Renderer::inlines(std::string_view str)
+{
+  std::string decoded;
+  std::size_t i {0};
+
+  while (i < str.size())
+  {
+    auto const pos = str.find_first_of("\\`*_~![<&\n", i);
+
+    text(str.substr(i, pos - i));
+
+    if (pos == std::string_view::npos)
+    {
+      break;
+    }
+
+    i = pos;
+    auto const c = str[i];
+
+    switch (c)
+    {
+      case '\\':
+      {
+        if (i + 1 < str.size() && str[i + 1] == '\n')
+        {
+          // hard line break
+          _os << "\n";
+          i += 2;
+        }
+        else if (i + 1 < str.size() && is_punct(str[i + 1]))
+        {
+          text(str.substr(i + 1, 1));
+          i += 2;
+        }
+        else
+        {
+          text("\\");
+          ++i;
+        }
+
+        break;
+      }
+
+      case '\n':
+      {
+        // two trailing spaces make a hard line break
+        if (i >= 2 && str[i - 1] == ' ' && str[i - 2] == ' ')
+        {
+          _os << "\n";
+        }
+        else
+        {
+          _os << " ";
+        }
+
+        ++i;
+
+        break;
+      }
+
+      case '`':
+      {
+        auto const n = run(str, i, '`');
+        auto end = std::string_view::npos;
+
+        for (auto j = str.find('`', i + n); j != std::string_view::npos;)
+        {
+          auto const m = run(str, j, '`');
+
+          if (m == n)
+          {
+            end = j;
+            break;
+          }
+
+          j = str.find('`', j + m);
+        }
+
+        if (end == std::string_view::npos)
+        {
+          text(str.substr(i, n));
+          i += n;
+
+          break;
+        }
+
+        std::string span {str.substr(i + n, end - i - n)};
+        std::replace(span.begin(), span.end(), '\n', ' ');
+
+        if (span.size() > 1 && span.front() == ' ' && span.back() == ' ' && ! is_blank(span))
+        {
+          span = span.substr(1, span.size() - 2);
+        }
+
+        _code = true;
+        pen();
+        text(span);
+        _code = false;
+        pen();
+        i = end + n;
+
+        break;
+      }
+
+      case '*':
+      case '_':
+      {
+        auto const n = run(str, i, c);
+        auto const prev = i ? str[i - 1] : ' ';
+        auto const next = i + n < str.size() ? str[i + n] : ' ';
+
+        bool const left {! is_space(next) && (! is_punct(next) || is_space(prev) || is_punct(prev))};
+        bool const right {! is_space(prev) && (! is_punct(prev) || is_space(next) || is_punct(next))};
+
+        // an underscore inside a word is not emphasis
+        bool const can_open {left && (c == '*' || ! right || is_punct(prev))};
+        bool const can_close {right && (c == '*' || ! left || is_punct(next))};
+
+        auto m = n;
+        bool changed {false};
+
+        if (can_close)
+        {
+          if (m >= 2 && _strong == c)
+          {
+            _strong = 0;
+            m -= 2;
+            changed = true;
+          }
+
+          if (m >= 1 && _em == c)
+          {
+            _em = 0;
+            m -= 1;
+            changed = true;
+          }
+        }
+
+        if (m && can_open)
+        {
+          if (m >= 2 && ! _strong && closer(str, i + n, c, 2))
+          {
+            _strong = c;
+            m -= 2;
+            changed = true;
+          }
+
+          if (m >= 1 && ! _em && closer(str, i + n, c, 1))
+          {
+            _em = c;
+            m -= 1;
+            changed = true;
+          }
+        }
+
+        if (changed)
+        {
+          pen();
+        }
+
+        text(str.substr(i, m));
+        i += n;
+
+        break;
+      }
+
+      case '~':
+      {
+        auto const n = run(str, i, '~');
+
+        if (n == 2 && _strike)
+        {
+          _strike = false;
+          pen();
+        }
+        else if (n == 2 && i + n < str.size() && ! is_space(str[i + n]) && closer(str, i + n, '~', 2))
+        {
+          _strike = true;
+          pen();
+        }
+        else
+        {
+          text(str.substr(i, n));
+        }
+
+        i += n;
+
+        break;
+      }
+
+      case '!':
+      {
+        if (i + 1 < str.size() && str[i + 1] == '[')
+        {
+          if (auto const n = link(str, i + 1, true))
+          {
+            i += 1 + n;
+
+            break;
+          }
+        }
+
+        text("!");
+        ++i;
+
+        break;
+      }
+
+      case '[':
+      {
+        if (auto const n = link(str, i, false))
+        {
+          i += n;
+
+          break;
+        }
+
+        text("[");
+        ++i;
+
+        break;
+      }
+
+      case '<':
+      {
+        auto const end = str.find('>', i);
+        auto const tag = end == std::string_view::npos ?
+          std::string_view {} : str.substr(i + 1, end - i - 1);
+
+        if (tag == "br" || tag == "br/" || tag == "br /")
+        {
+          _os << "\n";
+          i = end + 1;
+
+          break;
+        }
+
+        if ((tag.substr(0, 7) == "http://" || tag.substr(0, 8) == "https://" ||
+          tag.substr(0, 7) == "mailto:") && tag.find_first_of(" \t\n<") == std::string_view::npos)
+        {
+          _link = true;
+          pen();
+          text(tag);
+          _link = false;
+          pen();
+          i = end + 1;
+
+          break;
+        }
+
+        text("<");
+        ++i;
+
+        break;
+      }
+
+      case '&':
+      {
+        if (auto const n = entity(str.substr(i), decoded))
+        {
+          text(decoded);
+          i += n;
+
+          break;
+        }
+
+        text("&");
+        ++i;
+
+        break;
+      }
+
+      default:
+      {
+        text(str.substr(i, 1));
+        ++i;
+
+        break;
+      }
+    }
+  }
+}
+
+// write the link or image whose label starts at 'pos'
+// returns the length of the link, or 0 if it is not one
+std::size_t Renderer::link(std::string_view str, std::size_t pos, bool image)
+{
+  std::size_t depth {0};
+  auto i = pos;
+
+  for (; i < str.size(); ++i)
+  {
+    if (str[i] == '\\')
+    {
+      ++i;
+    }
+    else if (str[i] == '[')
+    {
+      ++depth;
+    }
+    else if (str[i] == ']' && --depth == 0)
+    {
+      break;
+    }
+  }
+
+  if (i >= str.size())
+  {
+    return 0;
+  }
+
+  auto const label = str.substr(pos + 1, i - pos - 1);
+  std::string_view url;
+  auto end = i + 1;
+
+  if (end < str.size() && str[end] == '(')
+  {
+    std::size_t parens {0};
+    auto j = end;
+
+    for (; j < str.size(); ++j)
+    {
+      if (str[j] == '\\')
+      {
+        ++j;
+      }
+      else if (str[j] == '(')
+      {
+        ++parens;
+      }
+      else if (str[j] == ')' && --parens == 0)
+      {
+        break;
+      }
+    }
+
+    if (j >= str.size())
+    {
+      return 0;
+    }
+
+    // the destination without the optional title
+    url = trim(str.substr(end + 1, j - end - 1));
+    url = url.substr(0, url.find_first_of(" \t\n"));
+
+    if (url.size() > 1 && url.front() == '<' && url.back() == '>')
+    {
+      url = url.substr(1, url.size() - 2);
+    }
+
+    end = j + 1;
+  }
+  else if (end < str.size() && str[end] == '[')
+  {
+    // a reference link, the definition is not shown
+    auto const j = str.find(']', end);
+
+    if (j == std::string_view::npos)
+    {
+      return 0;
+    }
+
+    end = j + 1;
+  }
+  else
+  {
+    return 0;
+  }
+
+  // images are shown as their alt text
+  if (image)
+  {
+    _os << aec::dim;
+    text("[");
+    text(label);
+    text("]");
+    pen();
+
+    return end - pos;
+  }
+
+  bool const is_link {_link};
+
+  _link = true;
+  pen();
+  inlines(label);
+  _link = is_link;
+  pen();
+
+  // the destination of a link around an image, such as a badge, is left out
+  if (url.substr(0, 4) == "http" && label.substr(0, 2) != "![")
+  {
+    _os << " " << aec::dim;
+    text("(");
+    text(url);
+    text(")");
+    pen();
+  }
+
+  return end - pos;
+}
+
+void Renderer::heading(std::size_t level, std::string_view str)
+{
+  begin();
+  margin();
+
+  switch (level)
+  {
+    case 1:
+    {
+      _base = aec::bold + aec::underline + aec::fg_magenta;
+      break;
+    }
+    case 2:
+    {
+      _base = aec::bold + aec::fg_magenta;
+      break;
+    }
+    default:
+    {
+      _base = aec::bold;
+      break;
+    }
+  }
+
+  pen();
+  inlines(trim(str));
+  end();
+}
+
+void Renderer::rule()
+{
+  begin();
+  margin();
+
+  auto const indent = (_quote + _lists.size()) * 2;
+  auto const width = _width > indent + 1 ? _width - indent - 1 : std::size_t {40};
+
+  // the stream counts bytes, so the multibyte line would wrap early
+  pre(true);
+  _os << aec::dim;
+
+  for (std::size_t i = 0; i < width; ++i)
+  {
+    _os << "─";
+  }
+
+  end();
+  pre(false);
+}
+
+// write a table row with the cells separated by a line
+// the delimiter row is left out and the header row is bold
+void Renderer::row(std::string_view str)
+{
+  std::vector<std::string_view> cells;
+
+  auto line = trim(str);
+  line.remove_prefix(1);
+
+  if (! line.empty() && line.back() == '|' && (line.size() < 2 || line[line.size() - 2] != '\\'))
+  {
+    line.remove_suffix(1);
+  }
+
+  std::size_t begin {0};
+
+  for (std::size_t i = 0; i <= line.size(); ++i)
+  {
+    if (i == line.size() || (line[i] == '|' && (i == 0 || line[i - 1] != '\\')))
+    {
+      cells.emplace_back(trim(line.substr(begin, i - begin)));
+      begin = i + 1;
+    }
+  }
+
+  bool const is_delim {std::all_of(cells.begin(), cells.end(), [](auto const& e) {
+    return ! e.empty() && e.find('-') != std::string_view::npos &&
+      e.find_first_not_of(":- ") == std::string_view::npos;
+  })};
+
+  if (is_delim)
+  {
+    return;
+  }
+
+  if (_rows++ == 0)
+  {
+    _base = aec::bold;
+  }
+
+  for (std::size_t i = 0; i < cells.size(); ++i)
+  {
+    if (i)
+    {
+      _os << aec::reset << aec::dim << " │ ";
+    }
+
+    pen();
+    inlines(cells.at(i));
+  }
+
+  end();
+}
+
+// write a line of html as it is
+void Renderer::raw(std::string_view str)
+{
+  _os << aec::dim;
+  text(str);
+  end();
+}
+
+// write a line of a code block
+void Renderer::code(std::string_view str)
+{
+  // tabs are expanded here, the stream would turn them into its own indent
+  _buf.clear();
+
+  for (auto const c : str)
+  {
+    if (c == '\t')
+    {
+      _buf.append(4 - _buf.size() % 4, ' ');
+    }
+    else if (static_cast<unsigned char>(c) >= 0x20 && c != 0x7f)
+    {
+      _buf += c;
+    }
+  }
+
+  if (! _lexer)
+  {
+    _os << aec::fg_green;
+    _os.write(_buf.data(), static_cast<std::streamsize>(_buf.size()));
+    _os << aec::reset << "\n";
+
+    return;
+  }
+
+  Highlight::line(*_lexer, _lex_state, _buf, _spans);
+
+  // the line is built whole and written once, the spans view into '_buf'
+  _code_buf.clear();
+
+  // the line starts with the style reset
+  auto token = Highlight::Token::text;
+
+  for (auto const& e : _spans)
+  {
+    if (e.token != token)
+    {
+      if (token != Highlight::Token::text)
+      {
+        _code_buf += aec::reset;
+      }
+
+      _code_buf += token_style(e.token);
+      token = e.token;
+    }
+
+    _code_buf += e.str;
+  }
+
+  _code_buf += aec::reset;
+  _code_buf += '\n';
+
+  _os.write(_code_buf.data(), static_cast<std::streamsize>(_code_buf.size()));
+}
+
+} // namespace OB::Stig::Markdown
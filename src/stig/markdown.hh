@@ -0,0 +1,140 @@
+#ifndef OB_STIG_MARKDOWN_HH
+#define OB_STIG_MARKDOWN_HH
+
+#include "stig/highlight.hh"
+
+#include "ob/term.hh"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ostream>
+
+namespace OB::Stig::Markdown
+{
+
+// render markdown to a terminal with ansi escape codes as it arrives
+// input is handled a line at a time, code blocks are written as each line
+// completes and only the paragraph being built is held, so memory is
+// bounded by the longest block rather than the whole document
+class Renderer
+{
+public:
+
+  // 'width' is the output width, 0 disables wrapping
+  Renderer(std::ostream& os, std::size_t width);
+
+  Renderer(Renderer const&) = delete;
+  Renderer& operator=(Renderer const&) = delete;
+
+  // render the complete lines in 'str', a trailing partial line is held until the rest arrives
+  void feed(std::string_view str);
+
+  // render what is left and close any open block
+  void finish();
+
+private:
+
+  enum class Block
+  {
+    none,
+    paragraph,
+    fence,
+    code,
+    html,
+    table,
+  };
+
+  struct List
+  {
+    // the column the item content starts at
+    std::size_t content;
+  }; // struct List
+
+  void line(std::string_view str);
+  void leaf(std::string_view str);
+  void para(std::string_view str);
+  void blank();
+  void close();
+  void bare();
+  void begin();
+  void margin();
+  void pen();
+  void end();
+  void pre(bool val);
+  void text(std::string_view str);
+  void inlines(std::string_view str);
+  std::size_t link(std::string_view str, std::size_t pos, bool image);
+  void heading(std::size_t level, std::string_view str);
+  void rule();
+  void row(std::string_view str);
+  void raw(std::string_view str);
+  void code(std::string_view str);
+
+  OB::Term::ostream _os;
+  std::size_t _width;
+
+  // the start of a line that has not been completed yet
+  std::string _line;
+
+  // the lines of the paragraph being built
+  std::string _para;
+
+  Block _block {Block::none};
+
+  // open lists, innermost last
+  std::vector<List> _lists;
+
+  // the marker of a list item that has not been written yet
+  std::string _marker;
+
+  // block quote depth
+  std::size_t _quote {0};
+
+  // the open code fence
+  char _fence_char {0};
+  std::size_t _fence_len {0};
+  std::size_t _fence_indent {0};
+  std::string _lang;
+
+  // highlights the open code block, null if its language is not known
+  Highlight::Lexer const* _lexer {nullptr};
+  std::uint8_t _lex_state {0};
+  std::vector<Highlight::Span> _spans;
+  std::string _code_buf;
+
+  // blank lines held inside an indented code block, dropped if the block ends
+  std::size_t _code_blank {0};
+
+  // rows written in the current table
+  std::size_t _rows {0};
+
+  // a blank line was read since the last block was written
+  bool _blank {false};
+
+  // something has been written
+  bool _wrote {false};
+
+  // the last block written was inside a list
+  bool _in_list {false};
+
+  // the style of the current block
+  std::string _base;
+
+  // open inline spans, emphasis holds the delimiter that opened it
+  char _strong {0};
+  char _em {0};
+  bool _strike {false};
+  bool _link {false};
+  bool _code {false};
+
+  // reused when writing text
+  std::string _buf;
+}; // class Renderer
+
+} // namespace OB::Stig::Markdown
+
+#endif // OB_STIG_MARKDOWN_HH
@@ -0,0 +1,118 @@
+#ifndef OB_STIG_REPO_HH
+#define OB_STIG_REPO_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include <string_view>
+#include <vector>
+#include <tuple>
+#include <memory>
+#include <utility>
+
+namespace OB::Stig
+{
+
+// repository metadata from a search result
+// the strings are views into the buffer the repo was read from,
+// a response body or a mapped file, which 'text' keeps alive
+struct Repo
+{
+  // unique GitHub repository id
+  std::uint64_t id {0};
+
+  std::string_view owner;
+  std::string_view name;
+  std::string_view description;
+  std::string_view language;
+  std::vector<std::string_view> topics;
+
+  std::size_t stars {0};
+  std::size_t forks {0};
+  std::size_t issues {0};
+  bool fork {false};
+
+  // time of the last push in seconds since the epoch
+  std::time_t pushed_at {0};
+
+  // time of the last update in seconds since the epoch, what the 'updated' sort orders by
+  // only kept for sorting, it is not one of the output fields
+  std::time_t updated_at {0};
+
+  // the id of the language from the intern pool, equal names have equal ids
+  // it indexes the color of the language, 0 is no language
+  std::uint32_t language_id {0};
+
+  // shared by the repos read from the same buffer
+  std::shared_ptr<void const> text;
+}; // struct Repo
+
+enum class Field_Kind : std::uint8_t
+{
+  number,
+  boolean,
+  string,
+
+  // a string that is null in json when empty
+  nullable,
+
+  // a list of strings
+  strings,
+
+  // seconds since the epoch, an iso 8601 string in text
+  time,
+};
+
+// describes a field of Repo
+template<auto Member, Field_Kind Kind>
+struct Repo_Field
+{
+  static constexpr auto member {Member};
+  static constexpr auto kind {Kind};
+
+  // the name in the output formats and templates
+  std::string_view name;
+
+  // the key in an item of an api search response,
+  // and the key inside that value if the field is nested
+  std::string_view key;
+  std::string_view sub {};
+}; // struct Repo_Field
+
+// the fields of Repo in output order
+// the api decoder and the json, tsv, csv, and template encoders are generated from it
+inline constexpr std::tuple repo_fields {
+  Repo_Field<&Repo::id, Field_Kind::number> {"id", "id"},
+  Repo_Field<&Repo::owner, Field_Kind::string> {"owner", "owner", "login"},
+  Repo_Field<&Repo::name, Field_Kind::string> {"name", "name"},
+  Repo_Field<&Repo::description, Field_Kind::nullable> {"description", "description"},
+  Repo_Field<&Repo::language, Field_Kind::nullable> {"language", "language"},
+  Repo_Field<&Repo::topics, Field_Kind::strings> {"topics", "topics"},
+  Repo_Field<&Repo::stars, Field_Kind::number> {"stars", "stargazers_count"},
+  Repo_Field<&Repo::forks, Field_Kind::number> {"forks", "forks_count"},
+  Repo_Field<&Repo::issues, Field_Kind::number> {"issues", "open_issues_count"},
+  Repo_Field<&Repo::fork, Field_Kind::boolean> {"fork", "fork"},
+  Repo_Field<&Repo::pushed_at, Field_Kind::time> {"pushed_at", "pushed_at"},
+};
+
+std::size_t constexpr repo_field_count {std::tuple_size_v<decltype(repo_fields)>};
+
+// call 'fn' with each field descriptor in order
+template<typename F>
+constexpr void for_each_field(F&& fn)
+{
+  std::apply([&](auto const&... e) { (fn(e), ...); }, repo_fields);
+}
+
+// call 'fn' with the field descriptor at 'pos'
+template<typename F>
+constexpr void visit_field(std::size_t pos, F&& fn)
+{
+  std::size_t i {0};
+  for_each_field([&](auto const& e) { if (i++ == pos) fn(e); });
+}
+
+} // namespace OB::Stig
+
+#endif // OB_STIG_REPO_HH
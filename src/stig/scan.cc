@@ -0,0 +1,768 @@
+#include "stig/scan.hh"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory_resource>
+#include <limits>
+#include <optional>
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+namespace OB::Stig::Scan
+{
+
+// a bit for each byte of a 64 byte block
+struct Block
+{
+  std::uint64_t quote;
+  std::uint64_t backslash;
+  std::uint64_t op;
+  std::uint64_t space;
+}; // struct Block
+
+// state carried from one block into the next
+struct Carry
+{
+  // the first byte of the next block is escaped
+  std::uint64_t escaped {0};
+
+  // all ones if the block ended inside a string
+  std::uint64_t in_string {0};
+
+  // the block ended inside a number or literal
+  std::uint64_t scalar {0};
+}; // struct Carry
+
+using Classify = Block (*)(char const* ptr);
+
+// prototypes
+Block classify_scalar(char const* ptr);
+template<typename T>
+std::uint64_t bits(int mask, std::size_t shift);
+#if defined(__x86_64__)
+Block classify_sse2(char const* ptr);
+Block classify_avx2(char const* ptr);
+#endif
+Classify classifier();
+std::uint64_t escaped(std::uint64_t backslash, std::uint64_t& carry);
+std::uint64_t prefix_xor(std::uint64_t bits);
+std::uint64_t structurals(Block const& block, Carry& carry);
+char* utf8(char* out, std::uint32_t cp);
+std::uint32_t hex4(std::string_view str);
+char* unescape(std::string_view str, char* out);
+
+Block classify_scalar(char const* ptr)
+{
+  Block res {0, 0, 0, 0};
+
+  for (std::size_t i = 0; i < 64; ++i)
+  {
+    auto const bit = std::uint64_t {1} << i;
+
+    switch (ptr[i])
+    {
+      case '"': res.quote |= bit; break;
+      case '\\': res.backslash |= bit; break;
+      case '{': case '}': case '[': case ']': case ':': case ',': res.op |= bit; break;
+      case ' ': case '\t': case '\n': case '\r': res.space |= bit; break;
+      default: break;
+    }
+  }
+
+  return res;
+}
+
+// place the movemask of a lane of T bits at 'shift'
+template<typename T>
+std::uint64_t bits(int mask, std::size_t shift)
+{
+  return static_cast<std::uint64_t>(static_cast<T>(mask)) << shift;
+}
+
+#if defined(__x86_64__)
+
+// '[' and ']' are '{' and '}' with bit 5 cleared,
+// so setting it matches all four brackets with two compares
+Block classify_sse2(char const* ptr)
+{
+  Block res {0, 0, 0, 0};
+
+  for (std::size_t i = 0; i < 64; i += 16)
+  {
+    auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ptr + i));
+    auto const lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+
+    auto const quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+    auto const backslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+    auto const op = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))),
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8(','))));
+    auto const space = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+
+    res.quote |= bits<std::uint16_t>(_mm_movemask_epi8(quote), i);
+    res.backslash |= bits<std::uint16_t>(_mm_movemask_epi8(backslash), i);
+    res.op |= bits<std::uint16_t>(_mm_movemask_epi8(op), i);
+    res.space |= bits<std::uint16_t>(_mm_movemask_epi8(space), i);
+  }
+
+  return res;
+}
+
+__attribute__((target("avx2")))
+Block classify_avx2(char const* ptr)
+{
+  Block res {0, 0, 0, 0};
+
+  for (std::size_t i = 0; i < 64; i += 32)
+  {
+    auto const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(ptr + i));
+    auto const lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+
+    auto const quote = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'));
+    auto const backslash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+    auto const op = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','))));
+    auto const space = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+
+    res.quote |= bits<std::uint32_t>(_mm256_movemask_epi8(quote), i);
+    res.backslash |= bits<std::uint32_t>(_mm256_movemask_epi8(backslash), i);
+    res.op |= bits<std::uint32_t>(_mm256_movemask_epi8(op), i);
+    res.space |= bits<std::uint32_t>(_mm256_movemask_epi8(space), i);
+  }
+
+  return res;
+}
+
+#endif
+
+Classify classifier()
+{
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx2"))
+  {
+    return classify_avx2;
+  }
+
+  return classify_sse2;
+#else
+  return classify_scalar;
+#endif
+}
+
+// the bytes escaped by a backslash, a run of backslashes escapes
+// the byte after it only if the run has an odd length
+// runs starting on even and odd bits are told apart by adding the run
+// starts to the backslashes, which carries through each run
+std::uint64_t escaped(std::uint64_t backslash, std::uint64_t& carry)
+{
+  std::uint64_t constexpr even {0x5555555555555555};
+
+  // a backslash escaped by the previous block does not escape
+  backslash &= ~carry;
+
+  auto const follows = (backslash << 1) | carry;
+  auto const odd_starts = backslash & ~even & ~follows;
+
+  std::uint64_t even_runs;
+  carry = __builtin_add_overflow(odd_starts, backslash, &even_runs);
+
+  return (even ^ (even_runs << 1)) & follows;
+}
+
+// each bit becomes the xor of itself and all bits below it,
+// turning the quotes of a block into the bytes inside of strings
+std::uint64_t prefix_xor(std::uint64_t bits)
+{
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+
+  return bits;
+}
+
+std::uint64_t structurals(Block const& block, Carry& carry)
+{
+  auto const quote = block.quote & ~escaped(block.backslash, carry.escaped);
+
+  // set from an opening quote up to but not including its closing quote
+  auto const in_string = prefix_xor(quote) ^ carry.in_string;
+  carry.in_string = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+
+  auto const op = block.op & ~in_string;
+
+  // numbers and literals are runs of bytes that are not anything else,
+  // only the first byte of each run is kept
+  auto const scalar = ~(block.op | block.space | quote | in_string);
+  auto const starts = scalar & ~((scalar << 1) | carry.scalar);
+  carry.scalar = scalar >> 63;
+
+  return op | quote | starts;
+}
+
+// write the utf-8 encoding of 'cp' to 'out', returns the end of what was written
+char* utf8(char* out, std::uint32_t cp)
+{
+  if (cp < 0x80)
+  {
+    *out++ = static_cast<char>(cp);
+  }
+  else if (cp < 0x800)
+  {
+    *out++ = static_cast<char>(0xc0 | (cp >> 6));
+    *out++ = static_cast<char>(0x80 | (cp & 0x3f));
+  }
+  else if (cp < 0x10000)
+  {
+    *out++ = static_cast<char>(0xe0 | (cp >> 12));
+    *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    *out++ = static_cast<char>(0x80 | (cp & 0x3f));
+  }
+  else
+  {
+    *out++ = static_cast<char>(0xf0 | (cp >> 18));
+    *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+    *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    *out++ = static_cast<char>(0x80 | (cp & 0x3f));
+  }
+
+  return out;
+}
+
+std::uint32_t hex4(std::string_view str)
+{
+  std::uint32_t res {0};
+
+  if (str.size() < 4 || std::from_chars(str.data(), str.data() + 4, res, 16).ptr != str.data() + 4)
+  {
+    throw std::runtime_error("json string has an invalid unicode escape");
+  }
+
+  return res;
+}
+
+// decode the escapes of a string into 'out', returns the end of what was written
+// the decoded string is never longer than 'str', so 'out' needs room for its size
+char* unescape(std::string_view str, char* out)
+{
+  for (std::size_t i = 0; i < str.size(); ++i)
+  {
+    if (str[i] != '\\')
+    {
+      *out++ = str[i];
+      continue;
+    }
+
+    if (++i == str.size())
+    {
+      throw std::runtime_error("json string has an invalid escape");
+    }
+
+    switch (str[i])
+    {
+      case '"': *out++ = '"'; break;
+      case '\\': *out++ = '\\'; break;
+      case '/': *out++ = '/'; break;
+      case 'b': *out++ = '\b'; break;
+      case 'f': *out++ = '\f'; break;
+      case 'n': *out++ = '\n'; break;
+      case 'r': *out++ = '\r'; break;
+      case 't': *out++ = '\t'; break;
+
+      case 'u':
+      {
+        auto cp = hex4(str.substr(i + 1));
+        i += 4;
+
+        // a surrogate pair
+        if (cp >= 0xd800 && cp < 0xdc00 && str.substr(i + 1, 2) == "\\u")
+        {
+          auto const lo = hex4(str.substr(i + 3));
+
+          if (lo >= 0xdc00 && lo < 0xe000)
+          {
+            cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+            i += 6;
+          }
+        }
+
+        out = utf8(out, cp);
+
+        break;
+      }
+
+      default:
+      {
+        throw std::runtime_error("json string has an invalid escape");
+      }
+    }
+  }
+
+  return out;
+}
+
+struct Document::Build
+{
+  // what may come next
+  enum class Expect {value, key, colon, comma};
+
+  Carry carry;
+
+  // the offset of the next block to read
+  std::size_t pos {0};
+
+  Expect expect {Expect::value};
+
+  // an object or array was just opened and may be closed right away
+  bool first {false};
+
+  // the tape positions of the open objects and arrays
+  std::vector<std::uint32_t> open;
+
+  // the opening quote of the string being read
+  std::optional<std::uint32_t> quote;
+}; // struct Document::Build
+
+Document::Document(std::string_view str) :
+  _str {str},
+  _build {std::make_unique<Build>()}
+{
+  if (str.size() > std::numeric_limits<std::uint32_t>::max())
+  {
+    throw std::runtime_error("json text is too large");
+  }
+
+  _tape.reserve(str.size() / 16);
+  finish();
+}
+
+Document::Document(std::string* buf) :
+  _buf {buf},
+  _build {std::make_unique<Build>()}
+{
+}
+
+Document::~Document() = default;
+
+void Document::reserve(std::size_t size)
+{
+  // the text could not be read anyway
+  if (size > std::numeric_limits<std::uint32_t>::max())
+  {
+    return;
+  }
+
+  _buf->reserve(size);
+  _tape.reserve(size / 16);
+}
+
+void Document::feed(std::string_view str)
+{
+  if (_buf->size() + str.size() > std::numeric_limits<std::uint32_t>::max())
+  {
+    throw std::runtime_error("json text is too large");
+  }
+
+  _buf->append(str);
+  _str = *_buf;
+  read(false);
+}
+
+void Document::finish()
+{
+  if (_buf)
+  {
+    _str = *_buf;
+  }
+
+  read(true);
+
+  if (_build->carry.in_string)
+  {
+    throw std::runtime_error("json string is not closed");
+  }
+
+  if (! _build->open.empty() || _build->expect != Build::Expect::comma)
+  {
+    throw std::runtime_error("json text ended early");
+  }
+
+  _build.reset();
+}
+
+// call structural with the offset of each structural character in order,
+// the '{', '}', '[', ']', ':', and ',' outside of strings, both quotes of each string,
+// and the first byte of each number or literal
+void Document::read(bool last)
+{
+  static Classify const classify {classifier()};
+
+  auto& pos = _build->pos;
+
+  auto const block = [&](char const* ptr)
+  {
+    for (auto bits = structurals(classify(ptr), _build->carry); bits; bits &= bits - 1)
+    {
+      structural(static_cast<std::uint32_t>(pos) + static_cast<std::uint32_t>(__builtin_ctzll(bits)));
+    }
+  };
+
+  for (; pos + 64 <= _str.size(); pos += 64)
+  {
+    block(_str.data() + pos);
+  }
+
+  if (last && pos < _str.size())
+  {
+    // the last partial block is padded with spaces
+    char tail[64];
+    std::memset(tail, ' ', sizeof(tail));
+    std::memcpy(tail, _str.data() + pos, _str.size() - pos);
+
+    block(tail);
+    pos = _str.size();
+  }
+}
+
+void Document::structural(std::uint32_t off)
+{
+  using Expect = Build::Expect;
+
+  auto const str = _str;
+  auto& expect = _build->expect;
+  auto& first = _build->first;
+  auto& open = _build->open;
+  auto& quote = _build->quote;
+
+  auto const value = [&](std::uint32_t begin, std::uint32_t end)
+  {
+    if (expect != Expect::value)
+    {
+      throw std::runtime_error("json expected a value");
+    }
+
+    _tape.emplace_back(Entry {begin, end, open.empty() ? std::numeric_limits<std::uint32_t>::max() : open.back()});
+    expect = Expect::comma;
+    first = false;
+  };
+
+  switch (str[off])
+  {
+    case '{':
+    case '[':
+    {
+      auto const pos = static_cast<std::uint32_t>(_tape.size());
+      value(off, 0);
+      open.emplace_back(pos);
+      expect = str[off] == '{' ? Expect::key : Expect::value;
+      first = true;
+
+      break;
+    }
+
+    case '}':
+    case ']':
+    {
+      if (open.empty() || str[_tape[open.back()].off] != (str[off] == '}' ? '{' : '['))
+      {
+        throw std::runtime_error("json has an unmatched bracket");
+      }
+
+      if (expect != Expect::comma && ! (first && expect != Expect::colon))
+      {
+        throw std::runtime_error("json expected a value");
+      }
+
+      _tape[open.back()].end = static_cast<std::uint32_t>(_tape.size());
+      open.pop_back();
+      expect = Expect::comma;
+      first = false;
+
+      break;
+    }
+
+    case ':':
+    {
+      if (expect != Expect::colon)
+      {
+        throw std::runtime_error("json expected a key");
+      }
+
+      expect = Expect::value;
+
+      break;
+    }
+
+    case ',':
+    {
+      if (expect != Expect::comma || open.empty())
+      {
+        throw std::runtime_error("json expected a value");
+      }
+
+      expect = str[_tape[open.back()].off] == '{' ? Expect::key : Expect::value;
+
+      break;
+    }
+
+    case '"':
+    {
+      // the entry is added at the closing quote
+      if (! quote)
+      {
+        quote = off;
+
+        break;
+      }
+
+      if (expect == Expect::key)
+      {
+        _tape.emplace_back(Entry {*quote, off, open.back()});
+        expect = Expect::colon;
+        first = false;
+      }
+      else
+      {
+        value(*quote, off);
+      }
+
+      quote.reset();
+
+      break;
+    }
+
+    default:
+    {
+      value(off, 0);
+
+      break;
+    }
+  }
+}
+
+std::size_t Document::next(std::size_t pos) const
+{
+  auto const& e = _tape[pos];
+
+  if (_str[e.off] == '{' || _str[e.off] == '[')
+  {
+    return e.end;
+  }
+
+  return pos + 1;
+}
+
+// a key is the only string followed by a colon
+bool Document::is_key(std::size_t pos) const
+{
+  auto const& e = _tape[pos];
+
+  if (_str[e.off] != '"')
+  {
+    return false;
+  }
+
+  auto const colon = _str.find_first_not_of(" \t\n\r", e.end + 1);
+
+  return colon != std::string_view::npos && _str[colon] == ':';
+}
+
+std::string_view Document::raw(std::size_t pos) const
+{
+  auto const& e = _tape[pos];
+
+  return _str.substr(e.off + 1, e.end - e.off - 1);
+}
+
+Value Value::Iterator::operator*() const
+{
+  return Value(_doc, _pos);
+}
+
+Value::Iterator& Value::Iterator::operator++()
+{
+  _pos = _doc->next(_pos);
+
+  return *this;
+}
+
+char Value::type() const
+{
+  if (! _doc)
+  {
+    return 0;
+  }
+
+  return _doc->_str[_doc->_tape[_pos].off];
+}
+
+// a number or literal runs until the next space or structural character
+std::string_view Value::scalar() const
+{
+  auto const begin = _doc->_tape[_pos].off;
+  auto const end = std::min(_doc->_str.find_first_of(" \t\n\r,]}", begin), _doc->_str.size());
+
+  return _doc->_str.substr(begin, end - begin);
+}
+
+std::string Value::string() const
+{
+  if (type() != '"')
+  {
+    throw std::runtime_error("json expected a string");
+  }
+
+  auto const str = _doc->raw(_pos);
+
+  if (str.find('\\') == std::string_view::npos)
+  {
+    return std::string(str);
+  }
+
+  std::string res(str.size(), '\0');
+  res.resize(static_cast<std::size_t>(unescape(str, res.data()) - res.data()));
+
+  return res;
+}
+
+std::string_view Value::string(std::pmr::memory_resource& res) const
+{
+  if (type() != '"')
+  {
+    throw std::runtime_error("json expected a string");
+  }
+
+  auto const str = _doc->raw(_pos);
+
+  if (str.find('\\') == std::string_view::npos)
+  {
+    return str;
+  }
+
+  auto* const data = static_cast<char*>(res.allocate(str.size(), 1));
+
+  return {data, static_cast<std::size_t>(unescape(str, data) - data)};
+}
+
+std::optional<std::string_view> Value::view() const
+{
+  if (type() != '"')
+  {
+    throw std::runtime_error("json expected a string");
+  }
+
+  if (auto const str = _doc->raw(_pos); str.find('\\') == std::string_view::npos)
+  {
+    return str;
+  }
+
+  return {};
+}
+
+std::uint64_t Value::integer() const
+{
+  if (! _doc)
+  {
+    throw std::runtime_error("json expected an unsigned integer");
+  }
+
+  auto const str = scalar();
+  std::uint64_t res {0};
+
+  if (auto const [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), res);
+    ec != std::errc() || ptr != str.data() + str.size())
+  {
+    throw std::runtime_error("json expected an unsigned integer");
+  }
+
+  return res;
+}
+
+bool Value::boolean() const
+{
+  if (auto const str = _doc ? scalar() : std::string_view(); str == "true")
+  {
+    return true;
+  }
+  else if (str == "false")
+  {
+    return false;
+  }
+
+  throw std::runtime_error("json expected a boolean");
+}
+
+Value Value::operator[](std::string_view key) const
+{
+  Key tmp {key};
+
+  return (*this)[tmp];
+}
+
+Value Value::operator[](Key& key) const
+{
+  if (! _doc)
+  {
+    return {};
+  }
+
+  if (type() != '{')
+  {
+    throw std::runtime_error("json expected an object");
+  }
+
+  std::size_t const end {_doc->_tape[_pos].end};
+
+  // the entry at the hint may belong to a nested object or be a value in another layout
+  if (auto const pos = _pos + key._hint; key._hint && pos < end &&
+    _doc->_tape[pos].parent == _pos && _doc->is_key(pos) && _doc->raw(pos) == key._name)
+  {
+    return Value(_doc, pos + 1);
+  }
+
+  for (auto pos = _pos + 1; pos < end; pos = _doc->next(pos + 1))
+  {
+    if (_doc->raw(pos) == key._name)
+    {
+      key._hint = static_cast<std::uint32_t>(pos - _pos);
+
+      return Value(_doc, pos + 1);
+    }
+  }
+
+  return {};
+}
+
+Value::Iterator Value::begin() const
+{
+  if (type() != '[')
+  {
+    throw std::runtime_error("json expected an array");
+  }
+
+  return Iterator(_doc, _pos + 1);
+}
+
+Value::Iterator Value::end() const
+{
+  return Iterator(_doc, _doc->_tape[_pos].end);
+}
+
+} // namespace OB::Stig::Scan
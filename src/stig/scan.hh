@@ -0,0 +1,199 @@
+#ifndef OB_STIG_SCAN_HH
+#define OB_STIG_SCAN_HH
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace OB::Stig::Scan
+{
+
+class Document;
+
+// a key to look up in objects that share a layout, such as the items of a search response
+// it remembers where it was found in the last object, so the next lookup
+// checks that place first and only walks the object when the layout differs
+class Key
+{
+public:
+
+  Key() = default;
+
+  explicit Key(std::string_view name) :
+    _name {name}
+  {
+  }
+
+private:
+
+  friend class Value;
+
+  std::string_view _name;
+
+  // the tape distance from the object to the key when it was last found
+  std::uint32_t _hint {0};
+}; // class Key
+
+// a value in a document, nothing is decoded until it is read
+// a default constructed value is a missing value
+// throws std::runtime_error if read as the wrong type
+class Value
+{
+public:
+
+  class Iterator
+  {
+  public:
+
+    Iterator(Document const* doc, std::size_t pos) :
+      _doc {doc},
+      _pos {pos}
+    {
+    }
+
+    Value operator*() const;
+    Iterator& operator++();
+
+    bool operator!=(Iterator const& rhs) const
+    {
+      return _pos != rhs._pos;
+    }
+
+  private:
+
+    Document const* _doc;
+    std::size_t _pos;
+  }; // class Iterator
+
+  Value() = default;
+
+  Value(Document const* doc, std::size_t pos) :
+    _doc {doc},
+    _pos {pos}
+  {
+  }
+
+  // true if the value is present
+  explicit operator bool() const
+  {
+    return _doc != nullptr;
+  }
+
+  // the first byte of the value, or 0 if it is missing
+  char type() const;
+
+  std::string string() const;
+
+  // the string as a view into the text, or if it has escapes, decoded into memory
+  // allocated from 'res', such as an arena released with the document
+  std::string_view string(std::pmr::memory_resource& res) const;
+
+  // the string as a view into the text, nothing if it has escapes that string() must decode
+  std::optional<std::string_view> view() const;
+
+  std::uint64_t integer() const;
+  bool boolean() const;
+
+  // the value of a key of an object, missing if the key is not there
+  Value operator[](std::string_view key) const;
+  Value operator[](Key& key) const;
+
+  // the elements of an array
+  Iterator begin() const;
+  Iterator end() const;
+
+private:
+
+  std::string_view scalar() const;
+
+  Document const* _doc {nullptr};
+  std::size_t _pos {0};
+}; // class Value
+
+// a json text read in one pass into a tape with an entry for each key and value
+// the structural characters are found 64 bytes at a time, with avx2 or sse2 when the cpu has them,
+// and containers record where they end, so unread values are stepped over in one move
+// the text must outlive the document, and the document its values
+// throws std::runtime_error on malformed input
+class Document
+{
+public:
+
+  explicit Document(std::string_view str);
+
+  // start a document whose text arrives in pieces, which feed appends to 'buf'
+  // each whole block is read as it arrives, so reading overlaps the arrival of the rest
+  // values can be read once finish returns
+  // taken by pointer so a string passed as a whole text is not fed by mistake
+  explicit Document(std::string* buf);
+
+  ~Document();
+
+  Document(Document const&) = delete;
+  Document& operator=(Document const&) = delete;
+
+  // make room for a text of 'size' bytes, such as the content length of the response it comes in
+  void reserve(std::size_t size);
+
+  // append 'str' to the text and read its whole blocks
+  void feed(std::string_view str);
+
+  // read the rest of the text
+  void finish();
+
+  Value root() const
+  {
+    return Value(this, 0);
+  }
+
+private:
+
+  friend class Value;
+
+  // the state of a document that is still being read
+  struct Build;
+
+  // read the blocks of the text not read yet, padding a partial last block if 'last'
+  void read(bool last);
+
+  void structural(std::uint32_t off);
+
+  struct Entry
+  {
+    // the offset of the first byte of the value
+    std::uint32_t off;
+
+    // the offset of the closing quote of a string,
+    // the tape position after the last entry of an object or array
+    std::uint32_t end;
+
+    // the tape position of the object or array holding the value
+    std::uint32_t parent;
+  }; // struct Entry
+
+  // the tape position after the value at 'pos'
+  std::size_t next(std::size_t pos) const;
+
+  bool is_key(std::size_t pos) const;
+
+  // the text of the string at 'pos' without its quotes
+  std::string_view raw(std::size_t pos) const;
+
+  std::string_view _str;
+  std::vector<Entry> _tape;
+
+  // the text being fed, null if the document was given its whole text
+  std::string* _buf {nullptr};
+
+  std::unique_ptr<Build> _build;
+}; // class Document
+
+} // namespace OB::Stig::Scan
+
+#endif // OB_STIG_SCAN_HH
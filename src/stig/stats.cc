@@ -0,0 +1,323 @@
+#include "stig/stats.hh"
+
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <new>
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <thread>
+#include <ostream>
+#include <iomanip>
+
+namespace OB::Stig::Stats
+{
+
+struct Sample
+{
+  // heap allocations made
+  std::size_t allocs {0};
+
+  // heap deallocations made
+  std::size_t frees {0};
+
+  // bytes requested from the heap
+  std::size_t bytes {0};
+
+  // wall clock time in microseconds
+  long int wall {0};
+
+  // user and system cpu time in microseconds
+  long int cpu {0};
+
+  // peak resident set size in kilobytes
+  long int rss {0};
+}; // struct Sample
+
+struct Phase
+{
+  char const* name {nullptr};
+  Sample begin {};
+  Sample end {};
+}; // struct Phase
+
+// prototypes
+void on_alloc(std::size_t size);
+void on_free();
+Sample sample();
+
+// counters are updated from the replaced global operator new and delete
+// they must not allocate and are safe to use before static initialization
+std::atomic<bool> enabled {false};
+std::atomic<std::size_t> allocs {0};
+std::atomic<std::size_t> frees {0};
+std::atomic<std::size_t> bytes {0};
+
+// phases are stored in a fixed size table so that recording them
+// does not perturb the allocation counts being measured
+std::array<Phase, 16> phases {};
+std::size_t phases_size {0};
+bool phase_active {false};
+
+// phases are only recorded on the thread that began the first one,
+// work done on other threads is counted in whichever phase is active
+std::thread::id phase_thread {};
+
+void enable()
+{
+  enabled.store(true, std::memory_order_relaxed);
+}
+
+void on_alloc(std::size_t size)
+{
+  if (! enabled.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+
+  allocs.fetch_add(1, std::memory_order_relaxed);
+  bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void on_free()
+{
+  if (! enabled.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+
+  frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+Sample sample()
+{
+  Sample res;
+
+  res.allocs = allocs.load(std::memory_order_relaxed);
+  res.frees = frees.load(std::memory_order_relaxed);
+  res.bytes = bytes.load(std::memory_order_relaxed);
+
+  res.wall = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+
+  rusage ru {};
+  if (getrusage(RUSAGE_SELF, &ru) == 0)
+  {
+    res.cpu =
+      (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 +
+      ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+    res.rss = ru.ru_maxrss;
+  }
+
+  return res;
+}
+
+void phase(char const* name)
+{
+  if (! enabled.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+
+  if (phase_thread == std::thread::id())
+  {
+    phase_thread = std::this_thread::get_id();
+  }
+  else if (phase_thread != std::this_thread::get_id())
+  {
+    return;
+  }
+
+  stop();
+
+  if (phases_size == phases.size())
+  {
+    return;
+  }
+
+  auto& e = phases.at(phases_size++);
+  e.name = name;
+  e.begin = sample();
+  phase_active = true;
+}
+
+void stop()
+{
+  if (! phase_active || phase_thread != std::this_thread::get_id())
+  {
+    return;
+  }
+
+  phases.at(phases_size - 1).end = sample();
+  phase_active = false;
+}
+
+void report(std::ostream& os)
+{
+  stop();
+
+  if (phases_size == 0)
+  {
+    return;
+  }
+
+  auto const row = [&](char const* name, Sample const& begin, Sample const& end)
+  {
+    os
+    << std::left << std::setw(10) << name << std::right
+    << std::setw(11) << static_cast<double>(end.wall - begin.wall) / 1000.0
+    << std::setw(11) << static_cast<double>(end.cpu - begin.cpu) / 1000.0
+    << std::setw(10) << end.allocs - begin.allocs
+    << std::setw(10) << end.frees - begin.frees
+    << std::setw(12) << end.bytes - begin.bytes
+    << std::setw(12) << end.rss
+    << "\n";
+  };
+
+  auto const flags = os.flags();
+  auto const precision = os.precision();
+
+  os
+  << std::fixed << std::setprecision(3)
+  << "\nStats:\n"
+  << std::left << std::setw(10) << "phase" << std::right
+  << std::setw(11) << "wall(ms)"
+  << std::setw(11) << "cpu(ms)"
+  << std::setw(10) << "allocs"
+  << std::setw(10) << "frees"
+  << std::setw(12) << "bytes"
+  << std::setw(12) << "rss(kb)"
+  << "\n";
+
+  for (std::size_t i = 0; i < phases_size; ++i)
+  {
+    row(phases.at(i).name, phases.at(i).begin, phases.at(i).end);
+  }
+
+  row("total", phases.at(0).begin, phases.at(phases_size - 1).end);
+
+  os.flags(flags);
+  os.precision(precision);
+}
+
+} // namespace OB::Stig::Stats
+
+// replace the global allocation functions to count heap usage
+// the nothrow and array forms forward to these in libstdc++ and libc++
+
+void* operator new(std::size_t size)
+{
+  OB::Stig::Stats::on_alloc(size);
+
+  if (size == 0)
+  {
+    size = 1;
+  }
+
+  for (;;)
+  {
+    if (void* ptr = std::malloc(size))
+    {
+      return ptr;
+    }
+
+    auto const handler = std::get_new_handler();
+
+    if (! handler)
+    {
+      throw std::bad_alloc();
+    }
+
+    handler();
+  }
+}
+
+void* operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+  OB::Stig::Stats::on_alloc(size);
+
+  auto const alignment = static_cast<std::size_t>(align);
+
+  // aligned_alloc wants a size that is a multiple of the alignment
+  size = (size + alignment - 1) & ~(alignment - 1);
+
+  if (size == 0)
+  {
+    size = alignment;
+  }
+
+  for (;;)
+  {
+    if (void* ptr = std::aligned_alloc(alignment, size))
+    {
+      return ptr;
+    }
+
+    auto const handler = std::get_new_handler();
+
+    if (! handler)
+    {
+      throw std::bad_alloc();
+    }
+
+    handler();
+  }
+}
+
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+  return ::operator new(size, align);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  if (ptr)
+  {
+    OB::Stig::Stats::on_free();
+    std::free(ptr);
+  }
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  ::operator delete(ptr);
+}
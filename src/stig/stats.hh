@@ -0,0 +1,26 @@
+#ifndef OB_STIG_STATS_HH
+#define OB_STIG_STATS_HH
+
+#include <ostream>
+
+namespace OB::Stig::Stats
+{
+
+// start counting allocations and recording phases
+// until called, the replaced operator new only tests a flag and phases are ignored
+void enable();
+
+// end the current phase and begin a new one named 'name'
+// 'name' must outlive the program, use a string literal
+// calls from a thread other than the one that began the first phase are ignored
+void phase(char const* name);
+
+// end the current phase
+void stop();
+
+// print the per phase allocation, memory, and timing summary
+void report(std::ostream& os);
+
+} // namespace OB::Stig::Stats
+
+#endif // OB_STIG_STATS_HH
@@ -1,6 +1,16 @@
 #include "stig/stig.hh"
 
 #include "stig/lang.hh"
+#include "stig/stats.hh"
+#include "stig/cache.hh"
+#include "stig/complete.hh"
+#include "stig/store.hh"
+#include "stig/repo.hh"
+#include "stig/format.hh"
+#include "stig/time.hh"
+#include "stig/markdown.hh"
+#include "stig/scan.hh"
+#include "stig/intern.hh"
 
 #include "ob/term.hh"
 namespace aec = OB::Term::ANSI_Escape_Codes;
@@ -8,32 +18,246 @@ namespace aec = OB::Term::ANSI_Escape_Codes;
 #include "ob/belle.hh"
 namespace Belle = OB::Belle;
 
-#include "lib/json.hh"
-using Json = nlohmann::json;
+#include "ob/ring.hh"
 
 #include <unistd.h>
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <cmath>
 #include <ctime>
 
 #include <string>
+#include <string_view>
+#include <sstream>
+#include <chrono>
 #include <iostream>
 #include <iomanip>
 #include <vector>
+#include <array>
 #include <utility>
 #include <optional>
+#include <algorithm>
+#include <functional>
+#include <charconv>
+#include <unordered_map>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 
 namespace OB::Stig
 {
 
+// a cached search response is this header followed by its repos in the store format,
+// so a cache hit is rendered from the mapped file without parsing any json
+struct Response_Header
+{
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::int32_t remaining;
+  std::int32_t limit;
+  std::uint32_t reserved;
+  std::uint64_t total;
+}; // struct Response_Header
+
+// the fields of a search response body that are used
+struct Search_Page
+{
+  std::vector<Repo> repos;
+  std::size_t total {0};
+  bool incomplete {false};
+
+  // readmes sent along with a graphql page
+  std::vector<std::pair<std::string, std::string>> readmes;
+
+  // the cursor a graphql page ends at, empty if it is the last page
+  std::string cursor;
+}; // struct Search_Page
+
+// a search response body, shared by the repos read from it
+struct Search_Text
+{
+  std::string body;
+
+  // the strings that had escapes, decoded into blocks released with the text
+  std::pmr::monotonic_buffer_resource decoded;
+}; // struct Search_Text
+
+// the keys read from each item of a search response, in the order of 'repo_fields'
+// items share a layout, so each key is looked for where it was in the item before
+struct Item_Keys
+{
+  Item_Keys()
+  {
+    std::size_t i {0};
+
+    for_each_field([&](auto const& e)
+    {
+      key.at(i) = Scan::Key(e.key);
+      sub.at(i) = Scan::Key(e.sub);
+      ++i;
+    });
+  }
+
+  std::array<Scan::Key, repo_field_count> key;
+
+  // the keys inside nested values
+  std::array<Scan::Key, repo_field_count> sub;
+
+  // read for sorting, not an output field
+  Scan::Key updated_at {"updated_at"};
+}; // struct Item_Keys
+
+// the keys read from each node of a graphql search response
+struct Node_Keys
+{
+  Scan::Key id {"databaseId"};
+  Scan::Key owner {"owner"};
+  Scan::Key login {"login"};
+  Scan::Key name {"name"};
+  Scan::Key description {"description"};
+  Scan::Key language {"primaryLanguage"};
+  Scan::Key language_name {"name"};
+  Scan::Key topics {"repositoryTopics"};
+  Scan::Key topic_nodes {"nodes"};
+  Scan::Key topic {"topic"};
+  Scan::Key topic_name {"name"};
+  Scan::Key stars {"stargazerCount"};
+  Scan::Key forks {"forkCount"};
+  Scan::Key issues {"issues"};
+  Scan::Key issue_count {"totalCount"};
+  Scan::Key pulls {"pullRequests"};
+  Scan::Key pull_count {"totalCount"};
+  Scan::Key fork {"isFork"};
+  Scan::Key pushed_at {"pushedAt"};
+  Scan::Key updated_at {"updatedAt"};
+}; // struct Node_Keys
+
+// parses a search response body on its own thread while the network thread is still receiving it
+// the body is handed over in pieces through a single producer single consumer ring whose slots are reused,
+// the lock is only taken to sleep when the ring is empty or full
+class Search_Parser
+{
+public:
+
+  // reads the page from the finished document
+  using Reader = Search_Page (*)(Scan::Document const&, std::shared_ptr<Search_Text> const&);
+
+  explicit Search_Parser(Reader read);
+  ~Search_Parser();
+
+  Search_Parser(Search_Parser const&) = delete;
+  Search_Parser& operator=(Search_Parser const&) = delete;
+
+  // make room for a body of 'size' bytes, must be called before the first piece
+  void reserve(std::size_t size);
+
+  // hand a piece of the body to the parser
+  void feed(std::string_view str);
+
+  // end the body and wait for the parser
+  // throws what the parser threw
+  Search_Page finish();
+
+private:
+
+  // an empty piece ends the body
+  void push(std::string_view str);
+
+  void run();
+
+  OB::Ring<std::string, 16> _ring;
+  std::mutex _mtx;
+  std::condition_variable _cv;
+
+  Reader _read;
+  std::shared_ptr<Search_Text> _text {std::make_shared<Search_Text>()};
+  Scan::Document _doc {&_text->body};
+  Search_Page _page;
+  std::exception_ptr _error;
+
+  // the end of the body has been pushed
+  bool _ended {false};
+
+  std::thread _thread;
+}; // class Search_Parser
+
+// how long the end cursor of a graphql page is used to fetch the page after it
+std::chrono::seconds constexpr cursor_max_age {24 * 60 * 60};
+
+std::array<char, 8> constexpr response_magic {{'s', 't', 'i', 'g', 'r', 'e', 's', 'p'}};
+std::uint32_t constexpr response_version {3};
+
+// a graphql search for the fields of 'repo_fields', the update time, and the cursor to page from,
+// and when '$readme' is set, a second search of the same results for the readmes of the first '$top'
+std::string_view constexpr graphql_search {R"(query($q: String!, $n: Int!, $top: Int!, $readme: Boolean!, $after: String) {
+  search(query: $q, type: REPOSITORY, first: $n, after: $after) {
+    repositoryCount
+    pageInfo { endCursor hasNextPage }
+    nodes {
+      ... on Repository {
+        databaseId owner { login } name description primaryLanguage { name }
+        repositoryTopics(first: 20) { nodes { topic { name } } }
+        stargazerCount forkCount issues(states: OPEN) { totalCount }
+        pullRequests(states: OPEN) { totalCount } isFork pushedAt updatedAt
+      }
+    }
+  }
+  top: search(query: $q, type: REPOSITORY, first: $top, after: $after) @include(if: $readme) {
+    nodes { ... on Repository { nameWithOwner object(expression: "HEAD:README.md") { ... on Blob { text } } } }
+  }
+})"};
+
 // prototypes
 void on_error(std::string const& str);
 void on_http_error(Belle::Client& app);
-std::pair<std::string, std::string> fuzzy_time(long int const sec);
+std::shared_ptr<Belle::Client::Pool> const& client_pool();
+Belle::Client& client_open(std::string const& host, Session* session,
+  std::optional<Belle::Client>& own);
+void client_send(Belle::Client& app);
+std::string_view search_string(Scan::Value val, Search_Text& text);
+std::time_t search_time(Scan::Value val);
+Repo search_repo(Scan::Value item, Item_Keys& keys, Search_Text& text);
+Search_Page search_page(Scan::Document const& doc, std::shared_ptr<Search_Text> const& text);
+Search_Page search_parse(std::string body);
+Repo graphql_repo(Scan::Value node, Node_Keys& keys, Search_Text& text);
+Search_Page graphql_page(Scan::Document const& doc, std::shared_ptr<Search_Text> const& text);
+void complete_add(std::vector<Repo> const& repos);
+std::vector<std::string_view> query_terms(std::string const& query);
+std::string set_key(std::string const& host, std::vector<std::string_view> terms);
+std::optional<Store::Result> search_covered(std::string const& host,
+  std::string const& query, std::string const& sort, std::string const& order,
+  std::size_t page, std::size_t per_page, std::size_t max_age);
+std::string response_encode(Response const& res);
+Belle::Request search_request(std::string const& host, std::string const& query,
+  std::string const& sort, std::string const& order, std::size_t page,
+  std::size_t per_page, std::string const& token);
+void json_quote(std::string& out, std::string_view str);
+std::string cursor_key(std::string const& host, std::string const& query,
+  std::string const& sort, std::string const& order, std::size_t page,
+  std::size_t per_page);
+Belle::Request graphql_request(std::string const& host, std::string const& query,
+  std::string const& sort, std::string const& order, std::size_t per_page,
+  std::string const& after, std::string const& token, std::size_t prefetch);
+void search_send(std::string const& host, Belle::Request req, Search_Parser& parser,
+  Response& res, Session* session);
+void watch_print(std::vector<Repo> const& prev, std::vector<Repo> const& repos,
+  bool const is_color);
+std::optional<Response> response_decode(Cache::Entry entry);
 void ostream_fmt(OB::Term::ostream& os, bool const is_term, bool const is_color);
-void search_print(Json const& js, std::pair<int, int> rate, std::size_t page,
-  std::size_t per_page, std::string const& color);
+std::string readme_key(std::string const& host, std::string const& repo,
+  std::string const& ref);
+Belle::Request readme_request(std::string const& host, std::string const& repo,
+  std::string const& ref);
+void search_print(std::vector<Repo> const& repos, std::size_t total_results,
+  std::optional<std::pair<int, int>> rate, std::size_t page,
+  std::size_t per_page, std::string const& color, std::string const& format,
+  Template::Program const& tmpl);
 
 void on_error(std::string const& str)
 {
@@ -43,79 +267,864 @@ void on_error(std::string const& str)
   );
 }
 
-void on_http_error(Belle::Client& app)
-{
-  app.on_http_error([&](auto& ctx)
+void on_http_error(Belle::Client& app)
+{
+  app.on_http_error([&](auto& ctx)
+  {
+    on_error(ctx.ec.message());
+  });
+}
+
+// the buffers shared by the clients of a thread, so the pages and readmes
+// of the interactive mode and the reconnects of watch reuse them
+std::shared_ptr<Belle::Client::Pool> const& client_pool()
+{
+  thread_local auto const pool = std::make_shared<Belle::Client::Pool>();
+
+  return pool;
+}
+
+Session::Session(std::string const& host) :
+  _client {std::make_unique<Belle::Client>(host, 443, true)}
+{
+  _client->keep_alive(true);
+}
+
+Session::~Session() = default;
+
+void Session::stop()
+{
+  _client->io().stop();
+}
+
+// get the client of 'session', or open a connection of its own in 'own' if it is null
+Belle::Client& client_open(std::string const& host, Session* session,
+  std::optional<Belle::Client>& own)
+{
+  if (session)
+  {
+    auto& app = session->client();
+    on_http_error(app);
+
+    return app;
+  }
+
+  auto& app = own.emplace(host, 443, true);
+  app.pool(client_pool());
+  on_http_error(app);
+
+  return app;
+}
+
+// send the queued requests of 'app', the queue is emptied if one fails,
+// so a session does not send it again with its next request
+void client_send(Belle::Client& app)
+{
+  auto const total = app.queue().size();
+  std::size_t completed {0};
+
+  try
+  {
+    completed = app.connect();
+  }
+  catch (...)
+  {
+    app.queue().clear();
+    throw;
+  }
+
+  if (completed != total)
+  {
+    app.queue().clear();
+    on_error("an HTTP error occurred");
+  }
+}
+
+// get a string of a search response as a view into the body,
+// decoding it into 'text' only if it has escapes
+std::string_view search_string(Scan::Value val, Search_Text& text)
+{
+  return val.string(text.decoded);
+}
+
+// read an iso 8601 time, 0 if it is null
+std::time_t search_time(Scan::Value val)
+{
+  if (val.type() == '"')
+  {
+    std::tm t = {};
+    std::stringstream ss (val.string());
+    if (ss >> std::get_time(&t, "%Y-%m-%dT%H:%M:%SZ"))
+    {
+      return timegm(&t);
+    }
+  }
+
+  return 0;
+}
+
+// read the displayed fields of one item of a search response
+// the other fields are stepped over without being decoded
+Repo search_repo(Scan::Value item, Item_Keys& keys, Search_Text& text)
+{
+  Repo repo;
+  std::size_t i {0};
+
+  for_each_field([&](auto const& e)
+  {
+    using D = std::decay_t<decltype(e)>;
+    auto& dst = repo.*D::member;
+    auto val = item[keys.key.at(i)];
+
+    if (! e.sub.empty())
+    {
+      val = val[keys.sub.at(i)];
+    }
+
+    ++i;
+
+    // a missing description, language, topics, or push time is null
+    if constexpr (D::kind == Field_Kind::number)
+    {
+      dst = val.integer();
+    }
+    else if constexpr (D::kind == Field_Kind::boolean)
+    {
+      dst = val.boolean();
+    }
+    else if constexpr (D::kind == Field_Kind::string)
+    {
+      dst = search_string(val, text);
+    }
+    else if constexpr (D::kind == Field_Kind::nullable)
+    {
+      if (val.type() == '"')
+      {
+        dst = search_string(val, text);
+      }
+    }
+    else if constexpr (D::kind == Field_Kind::strings)
+    {
+      if (val.type() == '[')
+      {
+        for (auto const str : val)
+        {
+          dst.emplace_back(search_string(str, text));
+        }
+      }
+    }
+    else if constexpr (D::kind == Field_Kind::time)
+    {
+      dst = search_time(val);
+    }
+  });
+
+  repo.updated_at = search_time(item[keys.updated_at]);
+
+  Intern::add(repo);
+
+  return repo;
+}
+
+// read the page from a document of the body held by 'text'
+// the repos share the body, which they view into
+Search_Page search_page(Scan::Document const& doc, std::shared_ptr<Search_Text> const& text)
+{
+  Search_Page res;
+  auto const root = doc.root();
+
+  res.total = root["total_count"].integer();
+  res.incomplete = root["incomplete_results"].type() == 't';
+
+  Item_Keys keys;
+
+  for (auto const item : root["items"])
+  {
+    res.repos.emplace_back(search_repo(item, keys, *text));
+    res.repos.back().text = text;
+  }
+
+  return res;
+}
+
+Search_Page search_parse(std::string body)
+{
+  auto const text = std::make_shared<Search_Text>();
+  text->body = std::move(body);
+
+  Scan::Document const doc {text->body};
+
+  return search_page(doc, text);
+}
+
+// read the fields of one node of a graphql search response
+// the values github nests in objects are unwrapped, so the repo matches one read from the v3 api
+Repo graphql_repo(Scan::Value node, Node_Keys& keys, Search_Text& text)
+{
+  Repo repo;
+
+  repo.id = node[keys.id].integer();
+  repo.owner = search_string(node[keys.owner][keys.login], text);
+  repo.name = search_string(node[keys.name], text);
+
+  if (auto const val = node[keys.description]; val.type() == '"')
+  {
+    repo.description = search_string(val, text);
+  }
+
+  if (auto const val = node[keys.language]; val.type() == '{')
+  {
+    repo.language = search_string(val[keys.language_name], text);
+  }
+
+  if (auto const val = node[keys.topics]; val.type() == '{')
+  {
+    for (auto const e : val[keys.topic_nodes])
+    {
+      repo.topics.emplace_back(search_string(e[keys.topic][keys.topic_name], text));
+    }
+  }
+
+  repo.stars = node[keys.stars].integer();
+  repo.forks = node[keys.forks].integer();
+  // v3 counts open pull requests as open issues, so both apis store and cache the same count
+  repo.issues = node[keys.issues][keys.issue_count].integer() +
+    node[keys.pulls][keys.pull_count].integer();
+  repo.fork = node[keys.fork].boolean();
+  repo.pushed_at = search_time(node[keys.pushed_at]);
+  repo.updated_at = search_time(node[keys.updated_at]);
+
+  Intern::add(repo);
+
+  return repo;
+}
+
+// read the page from a document of a graphql response body held by 'text'
+// errors are sent with a 200 status, the first one is thrown
+Search_Page graphql_page(Scan::Document const& doc, std::shared_ptr<Search_Text> const& text)
+{
+  Search_Page res;
+  auto const root = doc.root();
+
+  if (auto const errors = root["errors"]; errors.type() == '[')
+  {
+    for (auto const e : errors)
+    {
+      throw std::runtime_error("graphql " + e["message"].string());
+    }
+  }
+
+  auto const data = root["data"];
+  auto const search = data["search"];
+  res.total = search["repositoryCount"].integer();
+
+  if (auto const info = search["pageInfo"]; info.type() == '{' &&
+    info["hasNextPage"].type() == 't' && info["endCursor"].type() == '"')
+  {
+    res.cursor = info["endCursor"].string();
+  }
+
+  Node_Keys keys;
+
+  for (auto const node : search["nodes"])
+  {
+    res.repos.emplace_back(graphql_repo(node, keys, *text));
+    res.repos.back().text = text;
+  }
+
+  // a repo without a README.md, or with a binary one, has no text and is fetched on its own
+  if (auto const top = data["top"]; top.type() == '{')
+  {
+    for (auto const node : top["nodes"])
+    {
+      if (auto const blob = node["object"]; blob.type() == '{' && blob["text"].type() == '"')
+      {
+        res.readmes.emplace_back(node["nameWithOwner"].string(), blob["text"].string());
+      }
+    }
+  }
+
+  return res;
+}
+
+Search_Parser::Search_Parser(Reader read) :
+  _read {read},
+  _thread {[this] { run(); }}
+{
+}
+
+Search_Parser::~Search_Parser()
+{
+  // the body was not finished, the parser reads what it has and its error is dropped
+  if (! _ended)
+  {
+    push({});
+  }
+
+  if (_thread.joinable())
+  {
+    _thread.join();
+  }
+}
+
+void Search_Parser::reserve(std::size_t size)
+{
+  // the parser does not touch the document until the first piece is pushed
+  _doc.reserve(size);
+}
+
+void Search_Parser::feed(std::string_view str)
+{
+  if (! str.empty())
+  {
+    push(str);
+  }
+}
+
+Search_Page Search_Parser::finish()
+{
+  push({});
+  _thread.join();
+
+  if (_error)
+  {
+    std::rethrow_exception(_error);
+  }
+
+  return std::move(_page);
+}
+
+void Search_Parser::push(std::string_view str)
+{
+  auto slot = _ring.back();
+
+  if (! slot)
+  {
+    std::unique_lock<std::mutex> lock {_mtx};
+    _cv.wait(lock, [&] { return (slot = _ring.back()) != nullptr; });
+  }
+
+  slot->assign(str);
+  _ring.push();
+  _ended = str.empty();
+
+  // taking the lock orders the push before a sleeping parser checks the ring again
+  {
+    std::lock_guard<std::mutex> lock {_mtx};
+  }
+
+  _cv.notify_one();
+}
+
+void Search_Parser::run()
+{
+  for (bool end {false}; ! end;)
+  {
+    auto slot = _ring.front();
+
+    if (! slot)
+    {
+      std::unique_lock<std::mutex> lock {_mtx};
+      _cv.wait(lock, [&] { return (slot = _ring.front()) != nullptr; });
+    }
+
+    end = slot->empty();
+
+    if (! end && ! _error)
+    {
+      try
+      {
+        _doc.feed(*slot);
+      }
+      catch (...)
+      {
+        _error = std::current_exception();
+      }
+    }
+
+    _ring.pop();
+
+    {
+      std::lock_guard<std::mutex> lock {_mtx};
+    }
+
+    _cv.notify_one();
+  }
+
+  if (_error)
+  {
+    return;
+  }
+
+  try
+  {
+    _doc.finish();
+    _page = _read(_doc, _text);
+  }
+  catch (...)
+  {
+    _error = std::current_exception();
+  }
+}
+
+void complete_add(std::vector<Repo> const& repos)
+{
+  std::vector<std::string> names;
+
+  for (auto const& e : repos)
+  {
+    names.emplace_back(std::string(e.owner).append("/").append(e.name));
+  }
+
+  Complete::add(std::move(names));
+}
+
+std::vector<std::string_view> query_terms(std::string const& query)
+{
+  std::vector<std::string_view> res;
+  std::string_view str {query};
+
+  for (;;)
+  {
+    auto const begin = str.find_first_not_of(" \t\n");
+
+    if (begin == std::string_view::npos)
+    {
+      break;
+    }
+
+    str.remove_prefix(begin);
+    auto const end = std::min(str.find_first_of(" \t\n"), str.size());
+    res.emplace_back(str.substr(0, end));
+    str.remove_prefix(end);
+  }
+
+  return res;
+}
+
+// the key of a complete result set, it does not depend on how the set is sorted or paged
+// the terms are sorted, since their order does not change the results
+std::string set_key(std::string const& host, std::vector<std::string_view> terms)
+{
+  std::sort(terms.begin(), terms.end());
+
+  std::string res {"set\t" + host + "\t"};
+
+  for (std::size_t i = 0; i < terms.size(); ++i)
+  {
+    if (i)
+    {
+      res += " ";
+    }
+
+    res += terms.at(i);
+  }
+
+  return res;
+}
+
+// look for a cached complete result set that the query only re-sorts, re-pages,
+// or narrows with qualifiers that can be evaluated locally
+std::optional<Store::Result> search_covered(std::string const& host,
+  std::string const& query, std::string const& sort, std::string const& order,
+  std::size_t page, std::size_t per_page, std::size_t max_age)
+{
+  auto const terms = query_terms(query);
+
+  // positions of the terms that could have been added to narrow a set
+  std::vector<std::size_t> narrow;
+
+  for (std::size_t i = 0; i < terms.size() && narrow.size() < 6; ++i)
+  {
+    if (Store::filterable(terms.at(i)))
+    {
+      narrow.emplace_back(i);
+    }
+  }
+
+  // try each subset of the narrowing terms as the difference from a cached set
+  for (std::size_t mask = 0; mask < (std::size_t {1} << narrow.size()); ++mask)
+  {
+    std::vector<std::string_view> base;
+    std::string filter;
+
+    for (std::size_t i = 0, n = 0; i < terms.size(); ++i)
+    {
+      if (n < narrow.size() && narrow.at(n) == i)
+      {
+        if (mask & (std::size_t {1} << n++))
+        {
+          filter.append(terms.at(i)).append(" ");
+          continue;
+        }
+      }
+
+      base.emplace_back(terms.at(i));
+    }
+
+    if (base.empty())
+    {
+      continue;
+    }
+
+    auto entry = Cache::map(set_key(host, base), std::chrono::seconds(max_age));
+
+    if (! entry)
+    {
+      continue;
+    }
+
+    // entry is the sort the set was requested with followed by the encoded set
+    // best match order can only come from a set that was not sorted
+    auto const end = entry->val.find('\n');
+
+    if (end == std::string_view::npos || (sort.empty() && end != 0))
+    {
+      continue;
+    }
+
+    // the set already holds the forks its own query asked for
+    filter.append("fork:true");
+
+    auto const text = std::make_shared<Cache::Entry const>(std::move(*entry));
+
+    return Store::search(text->val.substr(end + 1), text, filter, sort, order, page, per_page);
+  }
+
+  return {};
+}
+
+std::string response_encode(Response const& res)
+{
+  auto const data = Store::serialize(res.repos);
+
+  if (data.empty())
+  {
+    return {};
+  }
+
+  Response_Header hdr {};
+  hdr.magic = response_magic;
+  hdr.version = response_version;
+  hdr.remaining = res.rate.value_or(std::make_pair(0, 0)).first;
+  hdr.limit = res.rate.value_or(std::make_pair(0, 0)).second;
+  hdr.total = res.total;
+
+  std::string buf (sizeof(Response_Header), '\0');
+  std::memcpy(buf.data(), &hdr, sizeof(Response_Header));
+  buf += data;
+
+  return buf;
+}
+
+// the repos view into the mapped entry, which they share
+std::optional<Response> response_decode(Cache::Entry entry)
+{
+  auto const text = std::make_shared<Cache::Entry const>(std::move(entry));
+  auto const buf = text->val;
+
+  if (buf.size() < sizeof(Response_Header))
+  {
+    return {};
+  }
+
+  Response_Header hdr;
+  std::memcpy(&hdr, buf.data(), sizeof(Response_Header));
+
+  if (hdr.magic != response_magic || hdr.version != response_version)
+  {
+    return {};
+  }
+
+  Response res;
+  res.rate = std::make_pair(hdr.remaining, hdr.limit);
+  res.total = static_cast<std::size_t>(hdr.total);
+  res.repos = Store::load(buf.substr(sizeof(Response_Header)), text);
+
+  return res;
+}
+
+Belle::Request search_request(std::string const& host, std::string const& query,
+  std::string const& sort, std::string const& order, std::size_t page,
+  std::size_t per_page, std::string const& token)
+{
+  Belle::Request req;
+  req.method(Belle::Method::get);
+
+  if (host == "api.github.com")
+  {
+    req.target("/search/repositories");
+  }
+  else
+  {
+    req.target("/api/v3/search/repositories");
+  }
+
+  req.set(Belle::Header::accept, "application/vnd.github.mercy-preview+json");
+
+  req.params().emplace("q", query);
+  req.params().emplace("sort", sort);
+  req.params().emplace("order", order);
+  req.params().emplace("page", std::to_string(page));
+  req.params().emplace("per_page", std::to_string(per_page));
+
+  if (! token.empty())
+  {
+    req.params().emplace("access_token", token);
+  }
+
+  return req;
+}
+
+// append 'str' to 'out' as a json string
+void json_quote(std::string& out, std::string_view str)
+{
+  char constexpr hex[] {"0123456789abcdef"};
+
+  out += '"';
+
+  for (auto const e : str)
+  {
+    auto const c = static_cast<unsigned char>(e);
+
+    if (c == '"' || c == '\\')
+    {
+      out += '\\';
+      out += e;
+    }
+    else if (c == '\n')
+    {
+      out += "\\n";
+    }
+    else if (c < 0x20)
+    {
+      out.append("\\u00").append(1, hex[c >> 4]).append(1, hex[c & 0xf]);
+    }
+    else
+    {
+      out += e;
+    }
+  }
+
+  out += '"';
+}
+
+// the cache key of the cursor that page 'page' of a graphql search ends at
+std::string cursor_key(std::string const& host, std::string const& query,
+  std::string const& sort, std::string const& order, std::size_t page,
+  std::size_t per_page)
+{
+  return "cursor\t" + host + "\t" + query + "\t" + sort + "\t" + order + "\t" +
+    std::to_string(page) + "\t" + std::to_string(per_page);
+}
+
+// a page of a search as one graphql query, which requires a token
+// the sort is a qualifier of the query, and the page starts after the cursor 'after',
+// the end cursor of the page before it, or at the first result if it is empty
+Belle::Request graphql_request(std::string const& host, std::string const& query,
+  std::string const& sort, std::string const& order, std::size_t per_page,
+  std::string const& after, std::string const& token, std::size_t prefetch)
+{
+  Belle::Request req;
+  req.method(Belle::Method::post);
+
+  if (host == "api.github.com")
+  {
+    req.target("/graphql");
+  }
+  else
+  {
+    req.target("/api/graphql");
+  }
+
+  req.set(Belle::Header::authorization, "bearer " + token);
+  req.set(Belle::Header::content_type, "application/json");
+
+  auto q = query;
+
+  if (! sort.empty())
   {
-    on_error(ctx.ec.message());
-  });
-}
+    q.append(" sort:").append(sort).append("-").append(order);
+  }
 
-template<typename T>
-std::optional<T> json_value(Json const& js)
-{
-  if (js.is_null())
+  auto& body = req.body();
+  body.append("{\"query\":");
+  json_quote(body, graphql_search);
+  body.append(",\"variables\":{\"q\":");
+  json_quote(body, q);
+  body.append(",\"n\":").append(std::to_string(per_page));
+  body.append(",\"top\":").append(std::to_string(std::clamp<std::size_t>(prefetch, 1, per_page)));
+  body.append(",\"readme\":").append(prefetch ? "true" : "false");
+
+  if (! after.empty())
   {
-    return {};
+    body.append(",\"after\":");
+    json_quote(body, after);
   }
-  return js.get<T>();
+
+  body.append("}}");
+
+  return req;
 }
 
-std::pair<std::string, std::string> fuzzy_time(long int const sec)
+// send the search request 'req', handing the body to 'parser' as it arrives,
+// and set the rate limit of 'res' from the response header
+void search_send(std::string const& host, Belle::Request req, Search_Parser& parser,
+  Response& res, Session* session)
 {
-  std::pair<std::string, std::string> res;
+  std::optional<Belle::Client> own;
+  auto& app = client_open(host, session, own);
+
+  app.on_http(std::move(req),
+    [&parser, first = true](auto& ctx, std::string_view str) mutable
+    {
+      // the status is reported once the response is complete
+      if (ctx.res.result() != Belle::Status::ok)
+      {
+        return;
+      }
 
-  long int constexpr t_second {1};
-  long int constexpr t_minute {t_second * 60};
-  long int constexpr t_hour   {t_minute * 60};
-  long int constexpr t_day    {t_hour * 24};
-  long int constexpr t_week   {t_day * 7};
-  long int constexpr t_month  (t_day * 30.4);
-  long int constexpr t_year   {t_month * 12};
+      if (std::exchange(first, false))
+      {
+        auto const len = ctx.res[Belle::Header::content_length];
+        std::size_t size {0};
 
-  std::time_t const now {std::time(nullptr)};
-  long int const dif {now - sec};
+        if (std::from_chars(len.data(), len.data() + len.size(), size).ec == std::errc())
+        {
+          parser.reserve(size);
+        }
+      }
 
-  auto const fuzzy_string = [&](long int const time_ref, std::string const time_str)
-  {
-    long int const fuzzy (dif / time_ref);
+      parser.feed(str);
+    },
+    [&res](auto& ctx)
+    {
+      if (ctx.res.result() != Belle::Status::ok)
+      {
+        std::stringstream ss; ss
+        << "HTTP "
+        << "'" << ctx.res.result_int() << "'"
+        << " " << ctx.res.reason();
+        on_error(ss.str());
+        return;
+      }
+
+      res.rate = std::make_pair(
+        std::stoi(std::string(ctx.res.at("X-RateLimit-Remaining"))),
+        std::stoi(std::string(ctx.res.at("X-RateLimit-Limit"))));
+    });
+
+  client_send(app);
+}
 
-    res.first = std::to_string(fuzzy);
-    res.second = time_str;
+Response search_fetch(std::string const& host, std::string const& query,
+  std::string const& sort, std::string const& order, std::size_t page,
+  std::size_t per_page, std::string const& token, std::size_t max_age,
+  std::string const& api, std::size_t prefetch, Session* session)
+{
+  // the token is left out of the key, it does not change the results
+  // the responses of each api are kept apart, so a graphql page is answered by graphql
+  // and saves the cursor the page after it starts at
+  auto const response_key = [&](bool graphql)
+  {
+    return (graphql ? "graphql\t" : "search\t") + host + "\t" + query + "\t" + sort +
+      "\t" + order + "\t" + std::to_string(page) + "\t" + std::to_string(per_page);
   };
 
-  if (dif >= t_year)
+  bool graphql {api == "graphql"};
+  auto key = response_key(graphql);
+
+  Stats::phase("cache");
+
+  if (max_age)
   {
-    fuzzy_string(t_year, "Y");
+    if (auto entry = Cache::map(key, std::chrono::seconds(max_age)))
+    {
+      if (auto res = response_decode(std::move(*entry)))
+      {
+        return std::move(res.value());
+      }
+    }
+
+    if (auto covered = search_covered(host, query, sort, order, page, per_page, max_age))
+    {
+      Response res;
+      res.total = covered->total;
+      res.repos = std::move(covered->repos);
+
+      return res;
+    }
   }
-  else if (dif >= t_month)
+
+  // a graphql page after the first starts at the end cursor of the page before it,
+  // saved when that page was fetched, without it the page comes from the v3 api
+  std::string after;
+
+  if (graphql && page > 1)
   {
-    fuzzy_string(t_month, "M");
+    after = Cache::get(cursor_key(host, query, sort, order, page - 1, per_page),
+      cursor_max_age).value_or("");
+
+    if (after.empty())
+    {
+      graphql = false;
+      key = response_key(graphql);
+    }
   }
-  else if (dif >= t_week)
+
+  Stats::phase("network");
+
+  Response res;
+
+  // the body is parsed as it arrives
+  Search_Parser parser {graphql ? graphql_page : search_page};
+
+  if (graphql)
   {
-    fuzzy_string(t_week, "W");
+    search_send(host, graphql_request(host, query, sort, order, per_page, after, token, prefetch),
+      parser, res, session);
   }
-  else if (dif >= t_day)
+  else
   {
-    fuzzy_string(t_day, "D");
+    search_send(host, search_request(host, query, sort, order, page, per_page, token),
+      parser, res, session);
   }
-  else if (dif >= t_hour)
+
+  Stats::phase("parse");
+  auto parsed = parser.finish();
+  res.repos = std::move(parsed.repos);
+  res.total = parsed.total;
+
+  Stats::phase("store");
+  complete_add(res.repos);
+  Store::add(res.repos);
+
+  // saved so a later readme request with '--cache' does not make a request
+  for (auto const& [repo, text] : parsed.readmes)
   {
-    fuzzy_string(t_hour, "h");
+    Cache::set(readme_key(host, repo, ""), text);
   }
-  else if (dif >= t_minute)
+
+  res.readmes = std::move(parsed.readmes);
+
+  if (! parsed.cursor.empty())
   {
-    fuzzy_string(t_minute, "m");
+    Cache::set(cursor_key(host, query, sort, order, page, per_page), parsed.cursor);
   }
-  else if (dif >= t_second)
+
+  if (auto const val = response_encode(res); ! val.empty())
   {
-    fuzzy_string(t_second, "s");
+    Cache::set(key, val);
   }
-  else
+
+  // a response holding every result can answer later requests
+  // for the same query with a different sort, page, or added filters
+  if (page == 1 && res.repos.size() == res.total && ! parsed.incomplete)
   {
-    res.first = "0";
-    res.second = "s";
+    if (auto const data = Store::serialize(res.repos); ! data.empty())
+    {
+      Cache::set(set_key(host, query_terms(query)), sort + "\n" + data);
+    }
   }
 
   return res;
@@ -123,65 +1132,278 @@ std::pair<std::string, std::string> fuzzy_time(long int const sec)
 
 void search(std::string const& host, std::string const& query,
   std::string const& sort, std::string const& order, std::size_t page,
-  std::size_t per_page, std::string const& token, std::string const& color)
+  std::size_t per_page, std::string const& token, std::string const& color,
+  std::string const& format, Template::Program const& tmpl, std::size_t max_age,
+  std::string const& api, std::size_t prefetch)
 {
-  Json js;
-  std::pair<int, int> rate;
-
-  Belle::Client app {host, 443, true};
-  on_http_error(app);
+  auto const res = search_fetch(host, query, sort, order, page, per_page, token, max_age,
+    api, prefetch);
 
-  Belle::Request req;
-  req.method(Belle::Method::get);
+  Stats::phase("render");
+  search_print(res.repos, res.total, res.rate, page, per_page, color, format, tmpl);
+}
 
-  if (host == "api.github.com")
+void watch(std::string const& host, std::string const& query,
+  std::string const& sort, std::string const& order, std::size_t page,
+  std::size_t per_page, std::string const& token, std::string const& color,
+  std::size_t interval)
+{
+  // color auto
+  bool is_color {OB::Term::is_term(STDOUT_FILENO)};
+  if (color == "on")
   {
-    req.target("/search/repositories");
+    is_color = true;
   }
-  else
+  else if (color == "off")
   {
-    req.target("/api/v3/search/repositories");
+    is_color = false;
   }
 
-  req.set(Belle::Header::accept, "application/vnd.github.mercy-preview+json");
+  auto const delay = std::chrono::seconds(interval);
+  std::vector<Repo> prev;
+  std::string etag;
 
-  req.params().emplace("q", query);
-  req.params().emplace("sort", sort);
-  req.params().emplace("order", order);
-  req.params().emplace("page", std::to_string(page));
-  req.params().emplace("per_page", std::to_string(per_page));
+  // the first response only seeds 'prev', later ones print what changed
+  bool seeded {false};
 
-  if (! token.empty())
+  // each pass holds one connection open for as long as the server keeps it alive
+  for (;;)
   {
-    req.params().emplace("access_token", token);
+    std::string error;
+    std::size_t polls {0};
+
+    Belle::Client app {host, 443, true};
+    app.pool(client_pool());
+    app.keep_alive(true);
+    app.on_http_error([&error](auto& ctx)
+    {
+      error = ctx.ec.message();
+    });
+
+    // waits out the interval between polls without blocking the io_context
+    Belle::net::steady_timer timer {app.io()};
+
+    std::function<void(Belle::Client::Http_Ctx&)> on_poll;
+
+    // queue a conditional request, an unchanged result set is answered with a 304
+    auto const poll = [&]()
+    {
+      auto req = search_request(host, query, sort, order, page, per_page, token);
+
+      if (! etag.empty())
+      {
+        req.set(Belle::Header::if_none_match, etag);
+      }
+
+      app.on_http(req.move(), on_poll);
+    };
+
+    on_poll = [&](auto& ctx)
+    {
+      ++polls;
+
+      if (ctx.res.result() == Belle::Status::ok)
+      {
+        try
+        {
+          auto repos = search_parse(std::move(ctx.res.body())).repos;
+          complete_add(repos);
+          Store::add(repos);
+
+          if (std::exchange(seeded, true))
+          {
+            watch_print(prev, repos, is_color);
+          }
+
+          prev = std::move(repos);
+          etag = std::string(ctx.res[Belle::Header::etag]);
+        }
+        catch (std::exception const& e)
+        {
+          std::cerr << "Error: " << e.what() << "\n";
+        }
+      }
+      else if (ctx.res.result() != Belle::Status::not_modified)
+      {
+        std::cerr
+        << "Error: HTTP "
+        << "'" << ctx.res.result_int() << "'"
+        << " " << ctx.res.reason() << "\n";
+      }
+
+      // the next request goes out on the connection left idle once this callback returns
+      timer.expires_after(delay);
+      timer.async_wait([&](Belle::error_code ec)
+      {
+        if (! ec)
+        {
+          poll();
+        }
+      });
+    };
+
+    poll();
+    app.connect();
+
+    // a connection that answered was closed by the server, reconnect right away,
+    // a request sent on it after it went idle has already been retried on a new one
+    if (! polls)
+    {
+      std::cerr << "Error: " << (error.empty() ? "an HTTP error occurred" : error) << "\n";
+      std::this_thread::sleep_for(delay);
+    }
+  }
+}
+
+void watch_print(std::vector<Repo> const& prev, std::vector<Repo> const& repos,
+  bool const is_color)
+{
+  std::unordered_map<std::uint64_t, Repo const*> before;
+  before.reserve(prev.size());
+
+  for (auto const& e : prev)
+  {
+    before.emplace(e.id, &e);
   }
 
-  app.on_http(req.move(), [&js, &rate](auto& ctx)
+  std::unordered_map<std::uint64_t, Repo const*> after;
+  after.reserve(repos.size());
+
+  for (auto const& e : repos)
+  {
+    after.emplace(e.id, &e);
+  }
+
+  std::ostringstream out;
+
+  auto const name = [&](Repo const& e)
+  {
+    out
+    << aec::wrap(e.owner, {aec::fg_magenta, aec::bold}, is_color)
+    << "/"
+    << aec::wrap(e.name, {aec::fg_white, aec::bold}, is_color);
+  };
+
+  // a counter with its change, such as '*120 (+3)'
+  auto const count = [&](char symbol, std::size_t val, std::size_t old, std::string const& attr)
   {
-    if (ctx.res.result() != Belle::Status::ok)
+    out
+    << " " << symbol
+    << aec::wrap(val, {attr, aec::bold}, is_color);
+
+    if (val != old)
     {
-      std::stringstream ss; ss
-      << "HTTP "
-      << "'" << ctx.res.result_int() << "'"
-      << " " << ctx.res.reason();
-      on_error(ss.str());
-      return;
+      out << " (" << (val > old ? "+" : "-") << (val > old ? val - old : old - val) << ")";
     }
+  };
 
-    rate.first = std::stoi(std::string(ctx.res.at("X-RateLimit-Remaining")));
-    rate.second = std::stoi(std::string(ctx.res.at("X-RateLimit-Limit")));
-    js = Json::parse(std::move(ctx.res.body()));
-  });
+  for (auto const& e : repos)
+  {
+    auto const it = before.find(e.id);
 
-  auto const total = app.queue().size();
-  auto const completed = app.connect();
+    if (it == before.end())
+    {
+      std::pair<std::string, std::string> updated;
+      if (e.pushed_at)
+      {
+        updated = fuzzy_time(e.pushed_at);
+      }
 
-  if (completed != total)
+      out << aec::wrap("+ ", {aec::fg_green, aec::bold}, is_color);
+      name(e);
+      out
+      << " *"
+      << aec::wrap(e.stars, {aec::fg_green, aec::bold}, is_color)
+      << " " << (e.fork ? ">" : "<")
+      << aec::wrap(e.forks, {aec::fg_blue, aec::bold}, is_color)
+      << " !"
+      << aec::wrap(e.issues, {aec::fg_cyan, aec::bold}, is_color)
+      << " ["
+      << aec::wrap(e.language, {Lang::escape(e.language_id), aec::bold}, is_color)
+      << "] "
+      << aec::wrap(updated.first + updated.second, {aec::fg_yellow, aec::bold}, is_color)
+      << "\n";
+
+      continue;
+    }
+
+    auto const& old = *it->second;
+
+    if (e.stars == old.stars && e.forks == old.forks && e.issues == old.issues &&
+      e.pushed_at == old.pushed_at)
+    {
+      continue;
+    }
+
+    out << aec::wrap("~ ", {aec::fg_yellow, aec::bold}, is_color);
+    name(e);
+
+    if (e.stars != old.stars)
+    {
+      count('*', e.stars, old.stars, aec::fg_green);
+    }
+
+    if (e.forks != old.forks)
+    {
+      count(e.fork ? '>' : '<', e.forks, old.forks, aec::fg_blue);
+    }
+
+    if (e.issues != old.issues)
+    {
+      count('!', e.issues, old.issues, aec::fg_cyan);
+    }
+
+    if (e.pushed_at > old.pushed_at)
+    {
+      auto const updated = fuzzy_time(e.pushed_at);
+      out << " pushed " << aec::wrap(updated.first + updated.second, {aec::fg_yellow, aec::bold}, is_color);
+    }
+
+    out << "\n";
+  }
+
+  for (auto const& e : prev)
   {
-    on_error("an HTTP error occurred");
+    if (after.find(e.id) == after.end())
+    {
+      out << aec::wrap("- ", {aec::fg_red, aec::bold}, is_color);
+      name(e);
+      out << "\n";
+    }
+  }
+
+  auto const str = out.str();
+
+  if (str.empty())
+  {
+    return;
   }
 
-  search_print(js, rate, page, per_page, color);
+  std::array<char, 24> buf;
+
+  // output formatter
+  OB::Term::ostream os {std::cout};
+  ostream_fmt(os, OB::Term::is_term(STDOUT_FILENO), is_color);
+
+  os
+  << aec::wrap(iso_time(std::time(nullptr), buf), {aec::fg_white, aec::bold}, is_color)
+  << "\n"
+  << str
+  << std::flush;
+
+  // the process runs until it is killed, so each batch must reach the pipe
+  std::cout << std::flush;
+}
+
+void search_local(std::string const& query, std::string const& sort,
+  std::string const& order, std::size_t page, std::size_t per_page,
+  std::string const& color, std::string const& format, Template::Program const& tmpl)
+{
+  Stats::phase("store");
+  auto const res = Store::search(query, sort, order, page, per_page);
+
+  Stats::phase("render");
+  search_print(res.repos, res.total, {}, page, per_page, color, format, tmpl);
 }
 
 void ostream_fmt(OB::Term::ostream& os, bool const is_term, bool const is_color)
@@ -201,9 +1423,18 @@ void ostream_fmt(OB::Term::ostream& os, bool const is_term, bool const is_color)
   }
 }
 
-void search_print(Json const& js, std::pair<int, int> rate, std::size_t page,
-  std::size_t per_page, std::string const& color)
+void search_print(std::vector<Repo> const& repos, std::size_t total_results,
+  std::optional<std::pair<int, int>> rate, std::size_t page,
+  std::size_t per_page, std::string const& color, std::string const& format,
+  Template::Program const& tmpl)
 {
+  if (format != "text")
+  {
+    Format::write(STDOUT_FILENO, format, repos, total_results);
+
+    return;
+  }
+
   // is stdout a tty
   bool is_term {OB::Term::is_term(STDOUT_FILENO)};
 
@@ -220,20 +1451,27 @@ void search_print(Json const& js, std::pair<int, int> rate, std::size_t page,
     is_color = false;
   }
 
+  if (! tmpl.code.empty())
+  {
+    Template::run(tmpl, STDOUT_FILENO, repos, is_color);
+
+    return;
+  }
+
   // output formatter
   OB::Term::ostream out {std::cout};
   ostream_fmt(out, is_term, is_color);
 
-  for (auto const& e : js["items"])
+  for (auto const& e : repos)
   {
-    auto const owner = e["owner"]["login"].get<std::string>();
-    auto const repo = e["name"].get<std::string>();
-    auto const stars = e["stargazers_count"].get<std::size_t>();
-    auto const fork = e["fork"].get<bool>();
-    auto const forks = e["forks_count"].get<std::size_t>();
-    auto const issues = e["open_issues_count"].get<std::size_t>();
-    auto const lang = json_value<std::string>(e["language"]).value_or("");
-    auto desc = json_value<std::string>(e["description"]).value_or("");
+    auto const& owner = e.owner;
+    auto const& repo = e.name;
+    auto const stars = e.stars;
+    auto const fork = e.fork;
+    auto const forks = e.forks;
+    auto const issues = e.issues;
+    auto const& lang = e.language;
+    std::string desc {e.description};
 
     if (desc.size() > 256)
     {
@@ -245,11 +1483,9 @@ void search_print(Json const& js, std::pair<int, int> rate, std::size_t page,
     std::string const fork_symbol {fork ? ">" : "<"};
 
     std::pair<std::string, std::string> updated;
-    std::tm t = {};
-    std::stringstream ss (e["pushed_at"].get<std::string>());
-    if (ss >> std::get_time(&t, "%Y-%m-%dT%H:%M:%SZ"))
+    if (e.pushed_at)
     {
-      updated = fuzzy_time(std::mktime(&t));
+      updated = fuzzy_time(e.pushed_at);
     }
 
     out
@@ -263,7 +1499,7 @@ void search_print(Json const& js, std::pair<int, int> rate, std::size_t page,
     << " !"
     << aec::wrap(issues, {aec::fg_cyan, aec::bold}, is_color)
     << " ["
-    << aec::wrap(lang, {aec::fg_true(Lang::color(lang)), aec::bold}, is_color)
+    << aec::wrap(lang, {Lang::escape(e.language_id), aec::bold}, is_color)
     << "] "
     << aec::wrap(updated.first, {aec::fg_yellow, aec::bold}, is_color)
     << aec::wrap(updated.second, {aec::fg_yellow, aec::bold}, is_color)
@@ -278,7 +1514,6 @@ void search_print(Json const& js, std::pair<int, int> rate, std::size_t page,
     }
   }
 
-  auto const total_results = js["total_count"].get<std::size_t>();
   auto const total_pages = static_cast<std::size_t>(std::ceil(static_cast<double>(total_results) / per_page));
 
   if (total_pages == 0)
@@ -286,7 +1521,7 @@ void search_print(Json const& js, std::pair<int, int> rate, std::size_t page,
     page = 0;
   }
 
-  std::size_t begin_results {js["items"].size() ? 1ul : 0ul};
+  std::size_t begin_results {repos.size() ? 1ul : 0ul};
   std::size_t end_results {per_page > total_results ? total_results : per_page};
 
   if (begin_results && page > 1)
@@ -321,21 +1556,34 @@ void search_print(Json const& js, std::pair<int, int> rate, std::size_t page,
   << aec::wrap(page, {aec::fg_magenta, aec::bold}, is_color)
   << "/"
   << aec::wrap(total_pages, {aec::fg_white, aec::bold}, is_color)
-  << " pages | "
-  << aec::wrap(rate.first, {aec::fg_magenta, aec::bold}, is_color)
-  << "/"
-  << aec::wrap(rate.second, {aec::fg_white, aec::bold}, is_color)
-  << " limit"
-  << "\n";
+  << " pages";
+
+  if (rate)
+  {
+    out
+    << " | "
+    << aec::wrap(rate->first, {aec::fg_magenta, aec::bold}, is_color)
+    << "/"
+    << aec::wrap(rate->second, {aec::fg_white, aec::bold}, is_color)
+    << " limit";
+  }
+  else
+  {
+    out << " | local";
+  }
+
+  out << "\n";
 }
 
-void readme(std::string const& host, std::string const& repo, std::string const& ref)
+std::string readme_key(std::string const& host, std::string const& repo,
+  std::string const& ref)
 {
-  std::string res;
-
-  Belle::Client app {host, 443, true};
-  on_http_error(app);
+  return "readme\t" + host + "\t" + repo + "\t" + ref;
+}
 
+Belle::Request readme_request(std::string const& host, std::string const& repo,
+  std::string const& ref)
+{
   Belle::Request req;
   req.method(Belle::Method::get);
 
@@ -355,20 +1603,147 @@ void readme(std::string const& host, std::string const& repo, std::string const&
     req.params().emplace("ref", ref);
   }
 
-  app.on_http(req.move(), [&res](auto& ctx)
+  return req;
+}
+
+std::string readme_fetch(std::string const& host, std::string const& repo,
+  std::string const& ref, std::size_t max_age, Session* session)
+{
+  std::string res;
+
+  auto const key = readme_key(host, repo, ref);
+
+  Stats::phase("cache");
+
+  if (max_age)
+  {
+    res = Cache::get(key, std::chrono::seconds(max_age)).value_or("");
+  }
+
+  if (res.empty())
+  {
+    Stats::phase("network");
+
+    std::optional<Belle::Client> own;
+    auto& app = client_open(host, session, own);
+
+    app.on_http(readme_request(host, repo, ref), [&res](auto& ctx)
+    {
+      if (ctx.res.result() != Belle::Status::ok)
+      {
+        std::stringstream ss; ss
+        << "HTTP "
+        << "'" << ctx.res.result_int() << "'"
+        << " " << ctx.res.reason();
+        on_error(ss.str());
+        return;
+      }
+
+      res = std::move(ctx.res.body());
+    });
+
+    client_send(app);
+
+    Cache::set(key, res);
+  }
+
+  return res;
+}
+
+void readme(std::string const& host, std::string const& repo, std::string const& ref,
+  std::string const& color, std::size_t max_age)
+{
+  // is stdout a tty
+  bool const is_term {OB::Term::is_term(STDOUT_FILENO)};
+
+  // color auto
+  bool is_color {is_term};
+  if (color == "on")
+  {
+    // color on
+    is_color = true;
+  }
+  else if (color == "off")
+  {
+    // color off
+    is_color = false;
+  }
+
+  // with color the markdown is rendered, otherwise it is written as it is
+  std::optional<Markdown::Renderer> md;
+
+  if (is_color)
+  {
+    md.emplace(std::cout, is_term ? OB::Term::width(STDOUT_FILENO) : 0);
+  }
+
+  auto const write = [&](std::string_view str)
+  {
+    if (md)
+    {
+      md->feed(str);
+    }
+    else
+    {
+      std::cout.write(str.data(), static_cast<std::streamsize>(str.size()));
+    }
+  };
+
+  auto const key = readme_key(host, repo, ref);
+
+  Stats::phase("cache");
+
+  if (max_age)
   {
-    if (ctx.res.result() != Belle::Status::ok)
+    if (auto const entry = Cache::map(key, std::chrono::seconds(max_age)))
     {
-      std::stringstream ss; ss
-      << "HTTP "
-      << "'" << ctx.res.result_int() << "'"
-      << " " << ctx.res.reason();
-      on_error(ss.str());
+      Stats::phase("render");
+      write(entry->val);
+
+      if (md)
+      {
+        md->finish();
+      }
+
+      std::cout << std::flush;
+
       return;
     }
+  }
 
-    res = std::move(ctx.res.body());
-  });
+  Stats::phase("network");
+
+  Belle::Client app {host, 443, true};
+  app.pool(client_pool());
+  on_http_error(app);
+
+  // the body is written and cached a piece at a time as it arrives
+  Cache::Writer cache {key};
+
+  app.on_http(readme_request(host, repo, ref),
+    [&](auto& ctx, std::string_view str)
+    {
+      // the status is reported once the response is complete
+      if (ctx.res.result() != Belle::Status::ok)
+      {
+        return;
+      }
+
+      write(str);
+      cache.append(str);
+      std::cout << std::flush;
+    },
+    [](auto& ctx)
+    {
+      if (ctx.res.result() != Belle::Status::ok)
+      {
+        std::stringstream ss; ss
+        << "HTTP "
+        << "'" << ctx.res.result_int() << "'"
+        << " " << ctx.res.reason();
+        on_error(ss.str());
+      }
+    });
 
   auto const total = app.queue().size();
   auto const completed = app.connect();
@@ -378,7 +1753,13 @@ void readme(std::string const& host, std::string const& repo, std::string const&
     on_error("an HTTP error occurred");
   }
 
-  std::cout << res << std::flush;
+  if (md)
+  {
+    md->finish();
+  }
+
+  std::cout << std::flush;
+  cache.commit();
 }
 
 } // namespace OB::Stig
@@ -1,17 +1,100 @@
 #ifndef OB_STIG_HH
 #define OB_STIG_HH
 
+#include "stig/repo.hh"
+#include "stig/template.hh"
+
 #include <cstddef>
 
 #include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <optional>
+
+namespace OB::Belle
+{
+class Client;
+} // namespace OB::Belle
 
 namespace OB::Stig
 {
 
+// a connection to the api kept open between the requests sent on it
+// the first request opens it, and a request finding it closed by the server opens it again
+// a session must only be used by one thread at a time
+class Session
+{
+public:
+
+  explicit Session(std::string const& host);
+  ~Session();
+
+  Session(Session const&) = delete;
+  Session& operator=(Session const&) = delete;
+
+  Belle::Client& client()
+  {
+    return *_client;
+  }
+
+  // end the request in flight, which fails, and any request started after it
+  // the only member that is safe to call from another thread
+  void stop();
+
+private:
+
+  std::unique_ptr<Belle::Client> _client;
+}; // class Session
+
+// a page of search results
+struct Response
+{
+  // remaining and total api requests, empty if not answered by the api
+  std::optional<std::pair<int, int>> rate;
+
+  // the number of repos matching the query
+  std::size_t total {0};
+
+  std::vector<Repo> repos;
+
+  // readmes fetched along with the page, as 'user/repo' and its markdown
+  std::vector<std::pair<std::string, std::string>> readmes;
+}; // struct Response
+
+// fetch a page of search results from the cache or the api
+// 'api' is 'v3' or 'graphql', a graphql request also fetches the readmes
+// of the first 'prefetch' results and saves them to the cache
+// the request is sent on 'session', or on a connection of its own if it is null
+Response search_fetch(std::string const& host, std::string const& query,
+  std::string const& sort, std::string const& order, std::size_t page,
+  std::size_t per_page, std::string const& token, std::size_t max_age,
+  std::string const& api, std::size_t prefetch, Session* session = nullptr);
+
+// fetch the markdown of the readme of 'repo' from the cache or the api
+// the request is sent on 'session', or on a connection of its own if it is null
+std::string readme_fetch(std::string const& host, std::string const& repo,
+  std::string const& ref, std::size_t max_age, Session* session = nullptr);
+
 void search(std::string const& host, std::string const& query,
   std::string const& sort, std::string const& order, std::size_t page,
-  std::size_t per_page, std::string const& token, std::string const& color);
-void readme(std::string const& host, std::string const& repo, std::string const& ref);
+  std::size_t per_page, std::string const& token, std::string const& color,
+  std::string const& format, Template::Program const& tmpl, std::size_t max_age,
+  std::string const& api, std::size_t prefetch);
+// poll the search every 'interval' seconds over one kept alive connection,
+// printing the repos added, removed, or changed since the last poll
+// unchanged results are answered with a 304 and are not parsed
+void watch(std::string const& host, std::string const& query,
+  std::string const& sort, std::string const& order, std::size_t page,
+  std::size_t per_page, std::string const& token, std::string const& color,
+  std::size_t interval);
+void search_local(std::string const& query, std::string const& sort,
+  std::string const& order, std::size_t page, std::size_t per_page,
+  std::string const& color, std::string const& format, Template::Program const& tmpl);
+// write the readme of 'repo' to stdout as it arrives
+// with color the markdown is rendered for the terminal, otherwise it is written as it is
+void readme(std::string const& host, std::string const& repo, std::string const& ref,
+  std::string const& color, std::size_t max_age);
 
 } // namespace OB::Stig
 
@@ -0,0 +1,1127 @@
+#include "stig/store.hh"
+
+#include "stig/cache.hh"
+#include "stig/intern.hh"
+#include "stig/lang.hh"
+
+#include "ob/mmap.hh"
+
+#include "ob/string.hh"
+namespace String = OB::String;
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <utility>
+#include <memory>
+#include <map>
+#include <unordered_map>
+#include <limits>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace OB::Stig::Store
+{
+
+// the store is a single file that is memory mapped and queried in place
+// every section starts on an 8 byte boundary
+//
+// header
+// id       u64[records]
+// pushed   i64[records]
+// updated  i64[records]
+// stars    u32[records]
+// forks    u32[records]
+// issues   u32[records]
+// fork     u8[records]
+// lang     u16[records], index into 'language'
+// field    u32[records * fields + 1], offsets into 'strings'
+// language u32[languages + 1], offsets into 'strings', entry 0 is empty
+// token    u32[tokens + 1], offsets into 'strings', sorted
+// posting  u32[tokens + 1], offsets into 'postings'
+// postings u32[postings], ascending record indices for each token
+// strings  char[strings]
+
+std::array<char, 8> constexpr magic {{'s', 't', 'i', 'g', 's', 't', 'o', 'r'}};
+std::uint32_t constexpr version {2};
+
+struct Header
+{
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t records;
+  std::uint32_t languages;
+  std::uint32_t tokens;
+  std::uint32_t postings;
+  std::uint32_t reserved;
+  std::uint64_t strings;
+}; // struct Header
+
+// string fields stored for each record, topics are space separated
+enum class Field : std::size_t
+{
+  owner,
+  name,
+  description,
+  topics,
+};
+
+std::size_t constexpr fields {4};
+
+// byte offset of each section
+struct Layout
+{
+  std::size_t id {0};
+  std::size_t pushed {0};
+  std::size_t updated {0};
+  std::size_t stars {0};
+  std::size_t forks {0};
+  std::size_t issues {0};
+  std::size_t fork {0};
+  std::size_t lang {0};
+  std::size_t field {0};
+  std::size_t language {0};
+  std::size_t token {0};
+  std::size_t posting {0};
+  std::size_t postings {0};
+  std::size_t strings {0};
+  std::size_t size {0};
+}; // struct Layout
+
+// typed view of a section
+// values are copied out so the mapping needs no particular alignment
+template<typename T>
+struct Column
+{
+  char const* data {nullptr};
+  std::size_t size {0};
+
+  T operator[](std::size_t const pos) const
+  {
+    T val;
+    std::memcpy(&val, data + pos * sizeof(T), sizeof(T));
+    return val;
+  }
+}; // struct Column
+
+// inclusive range of accepted values for a numeric qualifier
+struct Range
+{
+  std::int64_t lo {std::numeric_limits<std::int64_t>::min()};
+  std::int64_t hi {std::numeric_limits<std::int64_t>::max()};
+}; // struct Range
+
+enum class Key
+{
+  language,
+  stars,
+  forks,
+  pushed,
+  topic,
+  user,
+  repo,
+  fork,
+};
+
+struct Filter
+{
+  Key key;
+  bool negate {false};
+  Range range {};
+  std::string value {};
+  std::size_t language {0};
+}; // struct Filter
+
+struct Query
+{
+  std::vector<std::string> tokens;
+  std::vector<Filter> filters;
+
+  // the fields searched for tokens, set by 'in:'
+  std::array<bool, fields> in {{true, true, true, true}};
+}; // struct Query
+
+// read only view of a store held in 'buf'
+// 'buf' must outlive the view
+class View
+{
+public:
+
+  bool open(std::string_view buf);
+
+  std::size_t size() const
+  {
+    return _records;
+  }
+
+  std::string_view field(std::size_t rec, Field key) const
+  {
+    return str(_field, rec * fields + static_cast<std::size_t>(key));
+  }
+
+  // number of language names, including the empty name at position 0
+  std::size_t languages() const
+  {
+    return _language.size ? _language.size - 1 : 0;
+  }
+
+  std::string_view language(std::size_t pos) const
+  {
+    return str(_language, pos);
+  }
+
+  // get the ascending record indices containing 'token'
+  Column<std::uint32_t> find(std::string_view token) const;
+
+  Repo repo(std::size_t rec, std::shared_ptr<void const> const& text) const;
+
+  Column<std::uint64_t> id;
+  Column<std::int64_t> pushed;
+  Column<std::int64_t> updated;
+  Column<std::uint32_t> stars;
+  Column<std::uint32_t> forks;
+  Column<std::uint32_t> issues;
+  Column<std::uint8_t> fork;
+  Column<std::uint16_t> lang;
+
+private:
+
+  // get the string between offsets 'pos' and 'pos + 1' of 'col'
+  std::string_view str(Column<std::uint32_t> const& col, std::size_t pos) const
+  {
+    auto const begin = col[pos];
+    auto const end = col[pos + 1];
+
+    if (begin > end || end > _strings.size())
+    {
+      return {};
+    }
+
+    return _strings.substr(begin, end - begin);
+  }
+
+  std::size_t _records {0};
+  std::string_view _strings;
+  Column<std::uint32_t> _field;
+  Column<std::uint32_t> _language;
+  Column<std::uint32_t> _token;
+  Column<std::uint32_t> _posting;
+  Column<std::uint32_t> _postings;
+}; // class View
+
+// prototypes
+fs::path path();
+Layout layout(Header const& hdr);
+template<typename F> void tokenize(std::string_view str, F const& fn);
+std::int64_t parse_date(std::string_view str);
+Range parse_range(std::string_view str, std::string_view key, bool is_date);
+Query parse_query(std::string_view str, View const& view);
+bool match(Filter const& filter, View const& view, std::size_t rec);
+bool match_in(Query const& query, View const& view, std::size_t rec);
+bool same(View const& view, std::size_t rec, Repo const& repo);
+
+fs::path path()
+{
+  auto const dir = Cache::dir();
+
+  if (dir.empty())
+  {
+    return {};
+  }
+
+  return dir / "store";
+}
+
+Layout layout(Header const& hdr)
+{
+  Layout res;
+  std::size_t pos {sizeof(Header)};
+
+  auto const section = [&](std::size_t& off, std::size_t const bytes)
+  {
+    off = pos;
+    pos = (pos + bytes + 7) & ~std::size_t {7};
+  };
+
+  std::size_t const records {hdr.records};
+
+  section(res.id, records * sizeof(std::uint64_t));
+  section(res.pushed, records * sizeof(std::int64_t));
+  section(res.updated, records * sizeof(std::int64_t));
+  section(res.stars, records * sizeof(std::uint32_t));
+  section(res.forks, records * sizeof(std::uint32_t));
+  section(res.issues, records * sizeof(std::uint32_t));
+  section(res.fork, records * sizeof(std::uint8_t));
+  section(res.lang, records * sizeof(std::uint16_t));
+  section(res.field, (records * fields + 1) * sizeof(std::uint32_t));
+  section(res.language, (std::size_t {hdr.languages} + 1) * sizeof(std::uint32_t));
+  section(res.token, (std::size_t {hdr.tokens} + 1) * sizeof(std::uint32_t));
+  section(res.posting, (std::size_t {hdr.tokens} + 1) * sizeof(std::uint32_t));
+  section(res.postings, std::size_t {hdr.postings} * sizeof(std::uint32_t));
+  section(res.strings, static_cast<std::size_t>(hdr.strings));
+  res.size = pos;
+
+  return res;
+}
+
+bool View::open(std::string_view buf)
+{
+  if (buf.size() < sizeof(Header))
+  {
+    return false;
+  }
+
+  Header hdr;
+  std::memcpy(&hdr, buf.data(), sizeof(Header));
+
+  if (hdr.magic != magic || hdr.version != version)
+  {
+    return false;
+  }
+
+  auto const l = layout(hdr);
+
+  if (l.size > buf.size())
+  {
+    return false;
+  }
+
+  auto const data = buf.data();
+
+  _records = hdr.records;
+  id = {data + l.id, _records};
+  pushed = {data + l.pushed, _records};
+  updated = {data + l.updated, _records};
+  stars = {data + l.stars, _records};
+  forks = {data + l.forks, _records};
+  issues = {data + l.issues, _records};
+  fork = {data + l.fork, _records};
+  lang = {data + l.lang, _records};
+  _field = {data + l.field, _records * fields + 1};
+  _language = {data + l.language, std::size_t {hdr.languages} + 1};
+  _token = {data + l.token, std::size_t {hdr.tokens} + 1};
+  _posting = {data + l.posting, std::size_t {hdr.tokens} + 1};
+  _postings = {data + l.postings, hdr.postings};
+  _strings = {data + l.strings, static_cast<std::size_t>(hdr.strings)};
+
+  return true;
+}
+
+Column<std::uint32_t> View::find(std::string_view token) const
+{
+  // binary search the sorted token table
+  std::size_t lo {0};
+  std::size_t hi {_token.size ? _token.size - 1 : 0};
+
+  while (lo < hi)
+  {
+    auto const mid = lo + (hi - lo) / 2;
+
+    if (str(_token, mid) < token)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  if (lo == (_token.size ? _token.size - 1 : 0) || str(_token, lo) != token)
+  {
+    return {};
+  }
+
+  auto const begin = _posting[lo];
+  auto const end = _posting[lo + 1];
+
+  if (begin > end || end > _postings.size)
+  {
+    return {};
+  }
+
+  return {_postings.data + begin * sizeof(std::uint32_t), end - begin};
+}
+
+Repo View::repo(std::size_t rec, std::shared_ptr<void const> const& text) const
+{
+  Repo res;
+
+  res.id = id[rec];
+  res.owner = field(rec, Field::owner);
+  res.name = field(rec, Field::name);
+  res.description = field(rec, Field::description);
+
+  if (auto const pos = lang[rec]; pos < languages())
+  {
+    res.language = language(pos);
+  }
+
+  for (auto topics = field(rec, Field::topics); ! topics.empty();)
+  {
+    auto const end = std::min(topics.find(' '), topics.size());
+    res.topics.emplace_back(topics.substr(0, end));
+    topics.remove_prefix(std::min(end + 1, topics.size()));
+  }
+
+  res.stars = stars[rec];
+  res.forks = forks[rec];
+  res.issues = issues[rec];
+  res.fork = fork[rec];
+  res.pushed_at = static_cast<std::time_t>(pushed[rec]);
+  res.updated_at = static_cast<std::time_t>(updated[rec]);
+  res.text = text;
+  Intern::add(res);
+
+  return res;
+}
+
+// call 'fn' with each lowercase word in 'str'
+// a word is a run of ascii letters and digits, bytes above ascii are
+// kept so that utf-8 words stay whole
+template<typename F>
+void tokenize(std::string_view str, F const& fn)
+{
+  std::string word;
+
+  for (auto const c : str)
+  {
+    if (String::is(c, String::Class::alnum) || static_cast<unsigned char>(c) >= 0x80)
+    {
+      word += String::is(c, String::Class::upper) ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+    else if (! word.empty())
+    {
+      fn(std::move(word));
+      word.clear();
+    }
+  }
+
+  if (! word.empty())
+  {
+    fn(std::move(word));
+  }
+}
+
+std::string serialize(std::vector<Repo> const& repos)
+{
+  auto const to_u32 = [](std::size_t const val)
+  {
+    return static_cast<std::uint32_t>(std::min<std::size_t>(val, std::numeric_limits<std::uint32_t>::max()));
+  };
+
+  // language dictionary of intern ids and names, grouped by comparing ids
+  // languages in the table have ids in name order
+  std::vector<std::pair<std::uint32_t, std::string_view>> languages {{0, ""}};
+
+  for (auto const& e : repos)
+  {
+    if (e.language_id)
+    {
+      languages.emplace_back(e.language_id, e.language);
+    }
+  }
+
+  std::sort(languages.begin() + 1, languages.end());
+  languages.erase(std::unique(languages.begin(), languages.end()), languages.end());
+
+  if (languages.size() > std::numeric_limits<std::uint16_t>::max())
+  {
+    return {};
+  }
+
+  // columns, strings, and the inverted index
+  std::vector<std::uint64_t> id;
+  std::vector<std::int64_t> pushed;
+  std::vector<std::int64_t> updated;
+  std::vector<std::uint32_t> stars;
+  std::vector<std::uint32_t> forks;
+  std::vector<std::uint32_t> issues;
+  std::vector<std::uint8_t> fork;
+  std::vector<std::uint16_t> lang;
+  std::vector<std::uint32_t> field {0};
+  std::vector<std::uint32_t> language;
+  std::vector<std::uint32_t> token;
+  std::vector<std::uint32_t> posting {0};
+  std::vector<std::uint32_t> postings;
+  std::map<std::string, std::vector<std::uint32_t>> index;
+  std::string strings;
+
+  auto const append = [&](std::vector<std::uint32_t>& offsets, std::string_view const str)
+  {
+    strings.append(str);
+    offsets.emplace_back(to_u32(strings.size()));
+  };
+
+  for (std::size_t i = 0; i < repos.size(); ++i)
+  {
+    auto const& e = repos.at(i);
+    auto const rec = static_cast<std::uint32_t>(i);
+
+    id.emplace_back(e.id);
+    pushed.emplace_back(static_cast<std::int64_t>(e.pushed_at));
+    updated.emplace_back(static_cast<std::int64_t>(e.updated_at));
+    stars.emplace_back(to_u32(e.stars));
+    forks.emplace_back(to_u32(e.forks));
+    issues.emplace_back(to_u32(e.issues));
+    fork.emplace_back(e.fork);
+    lang.emplace_back(static_cast<std::uint16_t>(std::lower_bound(languages.begin(), languages.end(),
+      e.language_id, [](auto const& lhs, std::uint32_t rhs) { return lhs.first < rhs; }) - languages.begin()));
+
+    std::string topics;
+
+    for (auto const& t : e.topics)
+    {
+      topics.append(topics.empty() ? "" : " ").append(t);
+    }
+
+    append(field, e.owner);
+    append(field, e.name);
+    append(field, e.description);
+    append(field, topics);
+
+    auto const add = [&](std::string&& word)
+    {
+      auto& ids = index[std::move(word)];
+
+      if (ids.empty() || ids.back() != rec)
+      {
+        ids.emplace_back(rec);
+      }
+    };
+
+    tokenize(e.name, add);
+    tokenize(e.description, add);
+    tokenize(topics, add);
+  }
+
+  language.emplace_back(to_u32(strings.size()));
+
+  for (auto const& e : languages)
+  {
+    append(language, e.second);
+  }
+
+  token.emplace_back(to_u32(strings.size()));
+
+  for (auto const& [word, ids] : index)
+  {
+    append(token, word);
+    postings.insert(postings.end(), ids.begin(), ids.end());
+    posting.emplace_back(to_u32(postings.size()));
+  }
+
+  if (strings.size() >= std::numeric_limits<std::uint32_t>::max())
+  {
+    return {};
+  }
+
+  Header hdr {};
+  hdr.magic = magic;
+  hdr.version = version;
+  hdr.records = to_u32(repos.size());
+  hdr.languages = to_u32(languages.size());
+  hdr.tokens = to_u32(index.size());
+  hdr.postings = to_u32(postings.size());
+  hdr.strings = strings.size();
+
+  auto const l = layout(hdr);
+  std::string res (l.size, '\0');
+
+  auto const put = [&](std::size_t const off, auto const& vec)
+  {
+    if (! vec.empty())
+    {
+      std::memcpy(res.data() + off, vec.data(), vec.size() * sizeof(vec.front()));
+    }
+  };
+
+  std::memcpy(res.data(), &hdr, sizeof(Header));
+  put(l.id, id);
+  put(l.pushed, pushed);
+  put(l.updated, updated);
+  put(l.stars, stars);
+  put(l.forks, forks);
+  put(l.issues, issues);
+  put(l.fork, fork);
+  put(l.lang, lang);
+  put(l.field, field);
+  put(l.language, language);
+  put(l.token, token);
+  put(l.posting, posting);
+  put(l.postings, postings);
+  put(l.strings, strings);
+
+  return res;
+}
+
+// parse a 'YYYY-MM-DD' date into seconds since the epoch
+std::int64_t parse_date(std::string_view str)
+{
+  std::tm t = {};
+  std::istringstream ss {std::string(str)};
+
+  if (! (ss >> std::get_time(&t, "%Y-%m-%d")) || ss.peek() != std::char_traits<char>::eof())
+  {
+    throw std::runtime_error("date '" + std::string(str) + "' is invalid, expected 'YYYY-MM-DD'");
+  }
+
+  return static_cast<std::int64_t>(timegm(&t));
+}
+
+// parse 'n', '>n', '>=n', '<n', '<=n', or 'n..n' where either end may be '*'
+// a date covers a whole day
+Range parse_range(std::string_view str, std::string_view key, bool is_date)
+{
+  std::int64_t const width {is_date ? 86400 : 1};
+
+  auto const value = [&](std::string_view val) -> std::int64_t
+  {
+    if (is_date)
+    {
+      return parse_date(val);
+    }
+
+    if (val.empty() || ! String::all_of(val, String::Class::digit) || val.size() > 18)
+    {
+      throw std::runtime_error("qualifier '" + std::string(key) + "' has an invalid value '" + std::string(str) + "'");
+    }
+
+    return std::stoll(std::string(val));
+  };
+
+  Range res;
+
+  if (auto const pos = str.find(".."); pos != std::string_view::npos)
+  {
+    auto const lo = str.substr(0, pos);
+    auto const hi = str.substr(pos + 2);
+
+    if (lo != "*")
+    {
+      res.lo = value(lo);
+    }
+
+    if (hi != "*")
+    {
+      res.hi = value(hi) + width - 1;
+    }
+  }
+  else if (str.substr(0, 2) == ">=")
+  {
+    res.lo = value(str.substr(2));
+  }
+  else if (str.substr(0, 2) == "<=")
+  {
+    res.hi = value(str.substr(2)) + width - 1;
+  }
+  else if (str.substr(0, 1) == ">")
+  {
+    res.lo = value(str.substr(1)) + width;
+  }
+  else if (str.substr(0, 1) == "<")
+  {
+    res.hi = value(str.substr(1)) - 1;
+  }
+  else
+  {
+    res.lo = value(str);
+    res.hi = res.lo + width - 1;
+  }
+
+  return res;
+}
+
+Query parse_query(std::string_view str, View const& view)
+{
+  Query res;
+
+  while (! str.empty())
+  {
+    auto const begin = str.find_first_not_of(" \t\n");
+
+    if (begin == std::string_view::npos)
+    {
+      break;
+    }
+
+    str.remove_prefix(begin);
+    auto const end = std::min(str.find_first_of(" \t\n"), str.size());
+    auto term = str.substr(0, end);
+    str.remove_prefix(end);
+
+    auto const colon = term.find(':');
+
+    if (colon == std::string_view::npos || colon == 0)
+    {
+      tokenize(term, [&](std::string&& word)
+      {
+        res.tokens.emplace_back(std::move(word));
+      });
+
+      continue;
+    }
+
+    Filter filter {Key::language};
+
+    if (term.front() == '-')
+    {
+      filter.negate = true;
+      term.remove_prefix(1);
+    }
+
+    auto const key = String::lower(term.substr(0, term.find(':')));
+    auto const val = term.substr(term.find(':') + 1);
+
+    if (key == "language")
+    {
+      // an unknown language matches nothing
+      filter.language = view.languages();
+      auto const value = Lang::qualifier(val);
+      auto const name = Lang::alias(value);
+
+      for (std::size_t i = 1; i < view.languages(); ++i)
+      {
+        if (Lang::qualifier(view.language(i)) == name)
+        {
+          filter.language = i;
+          break;
+        }
+      }
+    }
+    else if (key == "stars" || key == "forks" || key == "pushed")
+    {
+      filter.key = key == "stars" ? Key::stars : key == "forks" ? Key::forks : Key::pushed;
+      filter.range = parse_range(val, key, filter.key == Key::pushed);
+    }
+    else if (key == "topic" || key == "user" || key == "org" || key == "repo")
+    {
+      filter.key = key == "topic" ? Key::topic : key == "repo" ? Key::repo : Key::user;
+      filter.value = String::lower(val);
+    }
+    else if (key == "fork" && String::one_of(val, {"true", "false", "only"}))
+    {
+      filter.key = Key::fork;
+      filter.value = val;
+    }
+    else if (key == "in" && ! filter.negate)
+    {
+      res.in = {{false, false, false, false}};
+
+      for (auto const& e : String::split(std::string(val), ","))
+      {
+        if (e == "name")
+        {
+          res.in.at(static_cast<std::size_t>(Field::name)) = true;
+        }
+        else if (e == "description")
+        {
+          res.in.at(static_cast<std::size_t>(Field::description)) = true;
+        }
+        else if (e == "topics")
+        {
+          res.in.at(static_cast<std::size_t>(Field::topics)) = true;
+        }
+        else
+        {
+          throw std::runtime_error("qualifier 'in' has an invalid value '" + e + "'");
+        }
+      }
+
+      continue;
+    }
+    else
+    {
+      throw std::runtime_error("qualifier '" + std::string(term) + "' is not supported by the local search");
+    }
+
+    res.filters.emplace_back(std::move(filter));
+  }
+
+  // like GitHub, forks are left out unless the query asks for them
+  if (std::none_of(res.filters.begin(), res.filters.end(), [](auto const& e) { return e.key == Key::fork; }))
+  {
+    Filter filter {Key::fork};
+    filter.value = "false";
+    res.filters.emplace_back(std::move(filter));
+  }
+
+  std::sort(res.tokens.begin(), res.tokens.end());
+  res.tokens.erase(std::unique(res.tokens.begin(), res.tokens.end()), res.tokens.end());
+
+  return res;
+}
+
+bool match(Filter const& filter, View const& view, std::size_t rec)
+{
+  bool res {false};
+
+  auto const in_range = [&](std::int64_t const val)
+  {
+    return val >= filter.range.lo && val <= filter.range.hi;
+  };
+
+  switch (filter.key)
+  {
+    case Key::language:
+      res = view.lang[rec] == filter.language;
+      break;
+
+    case Key::stars:
+      res = in_range(view.stars[rec]);
+      break;
+
+    case Key::forks:
+      res = in_range(view.forks[rec]);
+      break;
+
+    case Key::pushed:
+      res = in_range(view.pushed[rec]);
+      break;
+
+    case Key::topic:
+    {
+      auto topics = view.field(rec, Field::topics);
+
+      while (! res && ! topics.empty())
+      {
+        auto const end = std::min(topics.find(' '), topics.size());
+        res = String::lower(topics.substr(0, end)) == filter.value;
+        topics.remove_prefix(std::min(end + 1, topics.size()));
+      }
+
+      break;
+    }
+
+    case Key::user:
+      res = String::lower(view.field(rec, Field::owner)) == filter.value;
+      break;
+
+    case Key::repo:
+      res = String::lower(std::string(view.field(rec, Field::owner)) + "/" +
+        std::string(view.field(rec, Field::name))) == filter.value;
+      break;
+
+    case Key::fork:
+      res = filter.value == "true" || (filter.value == "only") == static_cast<bool>(view.fork[rec]);
+      break;
+
+    default:
+      break;
+  }
+
+  return res != filter.negate;
+}
+
+// check that each token appears in one of the fields selected with 'in:'
+bool match_in(Query const& query, View const& view, std::size_t rec)
+{
+  if (query.tokens.empty() || query.in == std::array<bool, fields> {{true, true, true, true}})
+  {
+    return true;
+  }
+
+  std::vector<std::string> words;
+
+  for (std::size_t i = 0; i < fields; ++i)
+  {
+    if (query.in.at(i))
+    {
+      tokenize(view.field(rec, static_cast<Field>(i)), [&](std::string&& word)
+      {
+        words.emplace_back(std::move(word));
+      });
+    }
+  }
+
+  std::sort(words.begin(), words.end());
+
+  return std::includes(words.begin(), words.end(), query.tokens.begin(), query.tokens.end());
+}
+
+std::vector<Repo> load(std::string_view buf, std::shared_ptr<void const> const& text)
+{
+  std::vector<Repo> res;
+  View view;
+
+  if (view.open(buf))
+  {
+    res.reserve(view.size());
+
+    for (std::size_t i = 0; i < view.size(); ++i)
+    {
+      res.emplace_back(view.repo(i, text));
+    }
+  }
+
+  return res;
+}
+
+// check if record 'rec' holds the same values as 'repo'
+bool same(View const& view, std::size_t rec, Repo const& repo)
+{
+  if (view.stars[rec] != repo.stars || view.forks[rec] != repo.forks ||
+    view.issues[rec] != repo.issues || static_cast<bool>(view.fork[rec]) != repo.fork ||
+    view.pushed[rec] != static_cast<std::int64_t>(repo.pushed_at) ||
+    view.updated[rec] != static_cast<std::int64_t>(repo.updated_at) ||
+    view.field(rec, Field::owner) != repo.owner || view.field(rec, Field::name) != repo.name ||
+    view.field(rec, Field::description) != repo.description)
+  {
+    return false;
+  }
+
+  auto const pos = view.lang[rec];
+
+  if ((pos < view.languages() ? view.language(pos) : std::string_view()) != repo.language)
+  {
+    return false;
+  }
+
+  auto topics = view.field(rec, Field::topics);
+
+  for (auto const& e : repo.topics)
+  {
+    auto const end = std::min(topics.find(' '), topics.size());
+
+    if (topics.substr(0, end) != e)
+    {
+      return false;
+    }
+
+    topics.remove_prefix(std::min(end + 1, topics.size()));
+  }
+
+  return topics.empty();
+}
+
+void add(std::vector<Repo> const& repos)
+{
+  auto const file = path();
+
+  if (file.empty() || repos.empty())
+  {
+    return;
+  }
+
+  auto const map = std::make_shared<OB::Mmap const>(file.string());
+
+  // most responses repeat repos that are already stored as they are,
+  // scanning the id column for them avoids decoding and rewriting the whole store
+  if (View view; view.open(map->view()))
+  {
+    std::unordered_map<std::uint64_t, Repo const*> want;
+
+    for (auto const& e : repos)
+    {
+      want.emplace(e.id, &e);
+    }
+
+    std::size_t found {0};
+    bool changed {false};
+
+    for (std::size_t i = 0; i < view.size() && ! changed; ++i)
+    {
+      if (auto const it = want.find(view.id[i]); it != want.end())
+      {
+        ++found;
+        changed = ! same(view, i, *it->second);
+      }
+    }
+
+    if (! changed && found == want.size())
+    {
+      return;
+    }
+  }
+
+  auto res = load(map->view(), map);
+
+  std::unordered_map<std::uint64_t, std::size_t> ids;
+
+  for (std::size_t i = 0; i < res.size(); ++i)
+  {
+    ids.emplace(res.at(i).id, i);
+  }
+
+  for (auto const& e : repos)
+  {
+    if (auto const it = ids.find(e.id); it != ids.end())
+    {
+      res.at(it->second) = e;
+    }
+    else
+    {
+      ids.emplace(e.id, res.size());
+      res.emplace_back(e);
+    }
+  }
+
+  auto const data = serialize(res);
+
+  if (! data.empty())
+  {
+    Cache::write(file, data);
+  }
+}
+
+bool filterable(std::string_view term)
+{
+  if (term.substr(0, 1) == "-")
+  {
+    term.remove_prefix(1);
+  }
+
+  auto const key = String::lower(term.substr(0, term.find(':')));
+
+  return term.find(':') != std::string_view::npos && String::one_of(key,
+    {"language", "stars", "forks", "pushed", "topic", "user", "org", "repo"});
+}
+
+Result search(std::string_view query, std::string_view sort,
+  std::string_view order, std::size_t page, std::size_t per_page)
+{
+  auto const map = std::make_shared<OB::Mmap>();
+  auto const file = path();
+
+  if (! file.empty())
+  {
+    map->open(file.string());
+  }
+
+  // records are in the order they were first seen,
+  // without a relevance score best match sorts by stars
+  return search(map->view(), map, query, sort.empty() ? "stars" : sort, order, page, per_page);
+}
+
+Result search(std::string_view buf, std::shared_ptr<void const> const& text,
+  std::string_view query, std::string_view sort, std::string_view order,
+  std::size_t page, std::size_t per_page)
+{
+  Result res;
+  View view;
+
+  if (! view.open(buf))
+  {
+    // still report an unsupported query without a store
+    parse_query(query, view);
+    return res;
+  }
+
+  auto const q = parse_query(query, view);
+
+  // intersect the posting lists, starting with the shortest
+  std::vector<Column<std::uint32_t>> lists;
+
+  for (auto const& e : q.tokens)
+  {
+    lists.emplace_back(view.find(e));
+  }
+
+  std::sort(lists.begin(), lists.end(), [](auto const& lhs, auto const& rhs)
+  {
+    return lhs.size < rhs.size;
+  });
+
+  std::vector<std::uint32_t> ids;
+
+  if (lists.empty())
+  {
+    ids.resize(view.size());
+
+    for (std::size_t i = 0; i < ids.size(); ++i)
+    {
+      ids.at(i) = static_cast<std::uint32_t>(i);
+    }
+  }
+  else
+  {
+    for (std::size_t i = 0; i < lists.front().size; ++i)
+    {
+      ids.emplace_back(lists.front()[i]);
+    }
+
+    for (std::size_t i = 1; i < lists.size() && ! ids.empty(); ++i)
+    {
+      auto const& list = lists.at(i);
+      std::size_t pos {0};
+
+      ids.erase(std::remove_if(ids.begin(), ids.end(), [&](std::uint32_t const rec)
+      {
+        while (pos < list.size && list[pos] < rec)
+        {
+          ++pos;
+        }
+
+        return pos == list.size || list[pos] != rec;
+      }), ids.end());
+    }
+  }
+
+  ids.erase(std::remove_if(ids.begin(), ids.end(), [&](std::uint32_t const rec)
+  {
+    if (rec >= view.size() || ! match_in(q, view, rec))
+    {
+      return true;
+    }
+
+    for (auto const& e : q.filters)
+    {
+      if (! match(e, view, rec))
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }), ids.end());
+
+  res.total = ids.size();
+
+  auto const key = [&](std::uint32_t const rec) -> std::int64_t
+  {
+    if (sort == "forks")
+    {
+      return view.forks[rec];
+    }
+
+    if (sort == "updated")
+    {
+      return view.updated[rec];
+    }
+
+    return view.stars[rec];
+  };
+
+  if (! sort.empty())
+  {
+    bool const asc {order == "asc"};
+
+    std::stable_sort(ids.begin(), ids.end(), [&](std::uint32_t const lhs, std::uint32_t const rhs)
+    {
+      return asc ? key(lhs) < key(rhs) : key(lhs) > key(rhs);
+    });
+  }
+
+  auto const begin = std::min(ids.size(), (page - 1) * per_page);
+  auto const end = std::min(ids.size(), begin + per_page);
+
+  for (auto i = begin; i < end; ++i)
+  {
+    res.repos.emplace_back(view.repo(ids.at(i), text));
+  }
+
+  return res;
+}
+
+} // namespace OB::Stig::Store
@@ -0,0 +1,59 @@
+#ifndef OB_STIG_STORE_HH
+#define OB_STIG_STORE_HH
+
+#include "stig/repo.hh"
+
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+
+namespace OB::Stig::Store
+{
+
+struct Result
+{
+  // the repos on the requested page
+  std::vector<Repo> repos;
+
+  // the number of repos matching the query
+  std::size_t total {0};
+}; // struct Result
+
+// encode 'repos' in the store format, in the given order
+// the repos must have been interned, languages are grouped by id
+// returns an empty string if they do not fit
+std::string serialize(std::vector<Repo> const& repos);
+
+// decode every record of the store encoded in 'buf', in order
+// the repos view into 'buf' and share 'text', which should keep it alive
+// returns an empty list if 'buf' is not in the store format
+std::vector<Repo> load(std::string_view buf, std::shared_ptr<void const> const& text);
+
+// merge 'repos' into the local store in the cache directory
+// records with the same id are replaced
+void add(std::vector<Repo> const& repos);
+
+// check if 'term' is a qualifier that the local search evaluates
+// the same way GitHub does
+bool filterable(std::string_view term);
+
+// search the local store using the GitHub search syntax
+// supports plain words and the 'language', 'stars', 'forks', 'pushed',
+// 'topic', 'user', 'org', 'repo', 'fork', and 'in' qualifiers
+// throws std::runtime_error if the query uses any other qualifier
+Result search(std::string_view query, std::string_view sort,
+  std::string_view order, std::size_t page, std::size_t per_page);
+
+// search the store encoded in 'buf'
+// the repos view into 'buf' and share 'text', which should keep it alive
+// an empty 'sort' keeps the stored order
+Result search(std::string_view buf, std::shared_ptr<void const> const& text,
+  std::string_view query, std::string_view sort, std::string_view order,
+  std::size_t page, std::size_t per_page);
+
+} // namespace OB::Stig::Store
+
+#endif // OB_STIG_STORE_HH
@@ -0,0 +1,270 @@
+#include "stig/template.hh"
+
+#include "stig/lang.hh"
+#include "stig/time.hh"
+#include "stig/format.hh"
+
+#include "ob/writer.hh"
+
+#include "ob/term.hh"
+namespace aec = OB::Term::ANSI_Escape_Codes;
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <utility>
+#include <stdexcept>
+
+namespace OB::Stig::Template
+{
+
+static_assert(static_cast<std::size_t>(Field::full_name) == repo_field_count,
+  "template fields must start with the repo fields");
+
+// field names accepted inside '{}'
+constexpr std::array<std::pair<std::string_view, Field>, 16> fields {{
+  {"description", Field::description},
+  {"desc", Field::description},
+  {"forks", Field::forks},
+  {"fork", Field::fork},
+  {"full_name", Field::full_name},
+  {"id", Field::id},
+  {"issues", Field::issues},
+  {"language", Field::language},
+  {"lang", Field::language},
+  {"name", Field::name},
+  {"owner", Field::owner},
+  {"pushed_at", Field::pushed_at},
+  {"repo", Field::name},
+  {"stars", Field::stars},
+  {"topics", Field::topics},
+  {"updated", Field::updated},
+}};
+
+// prototypes
+std::string color_code(std::string_view name);
+void emit(OB::Writer& out, Repo const& repo, Field field);
+
+// get the escape code for a color directive, or an empty string if it is unknown
+std::string color_code(std::string_view name)
+{
+  std::array<std::pair<std::string_view, std::string const*>, 23> const codes {{
+    {"reset", &aec::reset},
+    {"bold", &aec::bold},
+    {"dim", &aec::dim},
+    {"italic", &aec::italic},
+    {"underline", &aec::underline},
+    {"reverse", &aec::reverse},
+    {"black", &aec::fg_black},
+    {"red", &aec::fg_red},
+    {"green", &aec::fg_green},
+    {"yellow", &aec::fg_yellow},
+    {"blue", &aec::fg_blue},
+    {"magenta", &aec::fg_magenta},
+    {"cyan", &aec::fg_cyan},
+    {"white", &aec::fg_white},
+    {"bg-black", &aec::bg_black},
+    {"bg-red", &aec::bg_red},
+    {"bg-green", &aec::bg_green},
+    {"bg-yellow", &aec::bg_yellow},
+    {"bg-blue", &aec::bg_blue},
+    {"bg-magenta", &aec::bg_magenta},
+    {"bg-cyan", &aec::bg_cyan},
+    {"bg-white", &aec::bg_white},
+    {"blink", &aec::blink},
+  }};
+
+  for (auto const& [key, code] : codes)
+  {
+    if (name == key)
+    {
+      return *code;
+    }
+  }
+
+  // true color as '#rrggbb'
+  if (name.size() == 7 && name.front() == '#')
+  {
+    return aec::fg_true(std::string(name));
+  }
+
+  return {};
+}
+
+Program compile(std::string_view str)
+{
+  Program res;
+
+  // append literal text, extending the previous literal instruction when possible
+  auto const literal = [&](std::string_view text)
+  {
+    if (res.code.empty() || res.code.back().op != Op::literal ||
+      res.code.back().off + res.code.back().len != res.pool.size())
+    {
+      res.code.emplace_back(Instr {Op::literal, Field::id,
+        static_cast<std::uint32_t>(res.pool.size()), 0});
+    }
+
+    res.pool.append(text);
+    res.code.back().len += static_cast<std::uint32_t>(text.size());
+  };
+
+  for (std::size_t i = 0; i < str.size(); ++i)
+  {
+    auto const c = str[i];
+
+    if (c == '\\' && i + 1 < str.size())
+    {
+      switch (str[++i])
+      {
+        case 't': literal("\t"); break;
+        case 'n': literal("\n"); break;
+        case '\\': literal("\\"); break;
+        case '{': literal("{"); break;
+        case '}': literal("}"); break;
+        default: literal(str.substr(i - 1, 2)); break;
+      }
+
+      continue;
+    }
+
+    if (c != '{')
+    {
+      literal(str.substr(i, 1));
+      continue;
+    }
+
+    auto const end = str.find('}', i);
+
+    if (end == std::string_view::npos)
+    {
+      throw std::runtime_error("template has an unterminated '{' at position " + std::to_string(i));
+    }
+
+    auto const name = str.substr(i + 1, end - i - 1);
+    i = end;
+
+    if (name.substr(0, 1) == "%")
+    {
+      res.is_color = true;
+
+      if (name == "%lang" || name == "%language")
+      {
+        res.code.emplace_back(Instr {Op::language_color, Field::language, 0, 0});
+        continue;
+      }
+
+      auto const code = color_code(name.substr(1));
+
+      if (code.empty())
+      {
+        throw std::runtime_error("template color '" + std::string(name.substr(1)) + "' is unknown");
+      }
+
+      res.code.emplace_back(Instr {Op::color, Field::id,
+        static_cast<std::uint32_t>(res.pool.size()), static_cast<std::uint32_t>(code.size())});
+      res.pool.append(code);
+
+      continue;
+    }
+
+    bool found {false};
+
+    for (auto const& [key, field] : fields)
+    {
+      if (name == key)
+      {
+        res.code.emplace_back(Instr {Op::field, field, 0, 0});
+        found = true;
+        break;
+      }
+    }
+
+    if (! found)
+    {
+      throw std::runtime_error("template field '" + std::string(name) + "' is unknown");
+    }
+  }
+
+  return res;
+}
+
+void emit(OB::Writer& out, Repo const& repo, Field field)
+{
+  switch (field)
+  {
+    case Field::full_name:
+      out.put(repo.owner).put('/').put(repo.name);
+      break;
+
+    case Field::updated:
+      if (repo.pushed_at)
+      {
+        auto const [num, unit] = fuzzy_time(repo.pushed_at);
+        out.put(num).put(unit);
+      }
+
+      break;
+
+    default:
+      Format::field(out, repo, static_cast<std::size_t>(field));
+      break;
+  }
+}
+
+void run(Program const& prog, int fd, std::vector<Repo> const& repos, bool is_color)
+{
+  OB::Writer out {fd};
+  std::string_view const pool {prog.pool};
+
+  for (auto const& e : repos)
+  {
+    for (auto const& i : prog.code)
+    {
+      switch (i.op)
+      {
+        case Op::literal:
+          out.put(pool.substr(i.off, i.len));
+          break;
+
+        case Op::color:
+          if (is_color)
+          {
+            out.put(pool.substr(i.off, i.len));
+          }
+
+          break;
+
+        case Op::language_color:
+          if (is_color)
+          {
+            out.put(Lang::escape(e.language_id));
+          }
+
+          break;
+
+        case Op::field:
+          emit(out, e, i.field);
+          break;
+
+        default:
+          break;
+      }
+    }
+
+    if (is_color && prog.is_color)
+    {
+      out.put(aec::reset);
+    }
+
+    out.put('\n');
+  }
+
+  out.flush();
+}
+
+} // namespace OB::Stig::Template
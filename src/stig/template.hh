@@ -0,0 +1,80 @@
+#ifndef OB_STIG_TEMPLATE_HH
+#define OB_STIG_TEMPLATE_HH
+
+#include "stig/repo.hh"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace OB::Stig::Template
+{
+
+enum class Op : std::uint8_t
+{
+  // copy a run of the literal pool
+  literal,
+
+  // copy a run of the literal pool when color is enabled
+  color,
+
+  // emit the color of the repos language when color is enabled
+  language_color,
+
+  // emit a field of the repo
+  field,
+};
+
+// the fields of 'repo_fields' in the same order, followed by the derived fields
+enum class Field : std::uint8_t
+{
+  id,
+  owner,
+  name,
+  description,
+  language,
+  topics,
+  stars,
+  forks,
+  issues,
+  fork,
+  pushed_at,
+  full_name,
+  updated,
+};
+
+struct Instr
+{
+  Op op;
+  Field field;
+  std::uint32_t off;
+  std::uint32_t len;
+}; // struct Instr
+
+// a template compiled into a flat list of instructions
+struct Program
+{
+  std::vector<Instr> code;
+
+  // literal text and escape codes referenced by the instructions
+  std::string pool;
+
+  // true if the template contains a color directive
+  bool is_color {false};
+}; // struct Program
+
+// compile 'str' into a program
+// '{field}' emits a field, '{%name}' switches the color, and '\t', '\n',
+// '\\', '\{', and '\}' are escapes
+// throws std::runtime_error if the template is invalid
+Program compile(std::string_view str);
+
+// run 'prog' over each repo, writing one line per repo to the file descriptor 'fd'
+void run(Program const& prog, int fd, std::vector<Repo> const& repos, bool is_color);
+
+} // namespace OB::Stig::Template
+
+#endif // OB_STIG_TEMPLATE_HH
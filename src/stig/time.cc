@@ -0,0 +1,86 @@
+#include "stig/time.hh"
+
+#include <cstddef>
+#include <ctime>
+
+#include <string>
+#include <string_view>
+#include <array>
+#include <utility>
+
+namespace OB::Stig
+{
+
+std::pair<std::string, std::string> fuzzy_time(long int const sec)
+{
+  std::pair<std::string, std::string> res;
+
+  long int constexpr t_second {1};
+  long int constexpr t_minute {t_second * 60};
+  long int constexpr t_hour   {t_minute * 60};
+  long int constexpr t_day    {t_hour * 24};
+  long int constexpr t_week   {t_day * 7};
+  long int constexpr t_month  (t_day * 30.4);
+  long int constexpr t_year   {t_month * 12};
+
+  std::time_t const now {std::time(nullptr)};
+  long int const dif {now - sec};
+
+  auto const fuzzy_string = [&](long int const time_ref, std::string const time_str)
+  {
+    long int const fuzzy (dif / time_ref);
+
+    res.first = std::to_string(fuzzy);
+    res.second = time_str;
+  };
+
+  if (dif >= t_year)
+  {
+    fuzzy_string(t_year, "Y");
+  }
+  else if (dif >= t_month)
+  {
+    fuzzy_string(t_month, "M");
+  }
+  else if (dif >= t_week)
+  {
+    fuzzy_string(t_week, "W");
+  }
+  else if (dif >= t_day)
+  {
+    fuzzy_string(t_day, "D");
+  }
+  else if (dif >= t_hour)
+  {
+    fuzzy_string(t_hour, "h");
+  }
+  else if (dif >= t_minute)
+  {
+    fuzzy_string(t_minute, "m");
+  }
+  else if (dif >= t_second)
+  {
+    fuzzy_string(t_second, "s");
+  }
+  else
+  {
+    res.first = "0";
+    res.second = "s";
+  }
+
+  return res;
+}
+
+std::string_view iso_time(std::time_t sec, std::array<char, 24>& buf)
+{
+  std::tm t = {};
+
+  if (! sec || ! gmtime_r(&sec, &t))
+  {
+    return {};
+  }
+
+  return {buf.data(), std::strftime(buf.data(), buf.size(), "%Y-%m-%dT%H:%M:%SZ", &t)};
+}
+
+} // namespace OB::Stig
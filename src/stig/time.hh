@@ -0,0 +1,23 @@
+#ifndef OB_STIG_TIME_HH
+#define OB_STIG_TIME_HH
+
+#include <ctime>
+
+#include <string>
+#include <string_view>
+#include <array>
+#include <utility>
+
+namespace OB::Stig
+{
+
+// get the time elapsed since 'sec' as a count and a unit, such as '3' and 'M'
+std::pair<std::string, std::string> fuzzy_time(long int const sec);
+
+// format 'sec' as 'YYYY-MM-DDTHH:MM:SSZ' in 'buf'
+// returns an empty string for a zero time
+std::string_view iso_time(std::time_t sec, std::array<char, 24>& buf);
+
+} // namespace OB::Stig
+
+#endif // OB_STIG_TIME_HH
@@ -0,0 +1,951 @@
+#include "stig/tui.hh"
+
+#include "stig/stig.hh"
+#include "stig/store.hh"
+#include "stig/repo.hh"
+#include "stig/lang.hh"
+#include "stig/time.hh"
+#include "stig/markdown.hh"
+
+#include "ob/writer.hh"
+#include "ob/screen.hh"
+using Screen = OB::Term::Screen;
+using Style = OB::Term::Style;
+using Color = OB::Term::Color;
+
+#include "ob/term.hh"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <array>
+#include <unordered_map>
+#include <unordered_set>
+#include <optional>
+#include <utility>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+
+namespace OB::Stig::Tui
+{
+
+enum class Kind
+{
+  page,
+  readme,
+};
+
+struct Job
+{
+  Kind kind {Kind::page};
+  std::size_t page {0};
+  std::string repo;
+}; // struct Job
+
+// the outcome of a job, handed back to the ui thread
+struct Done
+{
+  Job job;
+  Response res;
+  std::string readme;
+
+  // the error message if the job failed
+  std::string error;
+}; // struct Done
+
+enum class Key
+{
+  none,
+  up,
+  down,
+  page_up,
+  page_down,
+  home,
+  end,
+  enter,
+  back,
+  quit,
+  retry,
+};
+
+struct State
+{
+  // every page loaded so far, in order
+  std::vector<Repo> repos;
+  std::size_t pages {0};
+  std::size_t total {0};
+  std::optional<std::pair<int, int>> rate;
+
+  // a page request is in flight
+  bool pending {false};
+
+  // the last page request failed, the next one waits for a retry
+  bool failed {false};
+
+  // the selected repo and the first repo on screen
+  std::size_t sel {0};
+  std::size_t top {0};
+
+  // the readme view, 'lines' point into 'text', the selected readme
+  // as drawn at 'text_width' columns, 0 if it needs drawing again
+  // 'line_styles' holds the style each line starts in
+  bool reading {false};
+  std::string readme_repo;
+  std::string text;
+  std::size_t text_width {0};
+  std::vector<std::string_view> lines;
+  std::vector<Style> line_styles;
+  std::size_t line_top {0};
+  std::unordered_map<std::string, std::string> readmes;
+
+  // the repos whose readme request is in flight
+  std::unordered_set<std::string> readme_pending;
+
+  // the last error, shown on the status line
+  std::string status;
+}; // struct State
+
+// the search api only returns the first 1000 results of a query
+std::size_t constexpr api_max_results {1000};
+
+// wakes the ui loop when a job is done or a signal arrives,
+// written to from the signal handlers so it must be a global
+std::array<int, 2> wake_fd {{-1, -1}};
+
+// prototypes
+void on_signal(int sig);
+void wake(char c);
+std::pair<Key, std::size_t> key_parse(std::string_view buf);
+std::string_view first_line(std::string_view str);
+std::size_t available(State const& st, Options const& opts);
+void readme_lines(State& st, Options const& opts, std::size_t width);
+void apply(State& st, Done& done);
+void scroll(State& st, std::size_t rows);
+void on_key(State& st, Key key, std::size_t rows, bool& running, std::vector<Job>& jobs);
+void draw_list(Screen& scr, State const& st, Options const& opts, std::size_t rows);
+void draw_readme(Screen& scr, State const& st, std::size_t rows);
+void draw(Screen& scr, State const& st, Options const& opts);
+
+// the self pipe behind 'wake_fd'
+class Pipe
+{
+public:
+
+  Pipe()
+  {
+    if (::pipe(wake_fd.data()) == -1)
+    {
+      throw std::runtime_error("could not create a pipe");
+    }
+
+    for (auto const fd : wake_fd)
+    {
+      ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+      ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+  }
+
+  Pipe(Pipe const&) = delete;
+  Pipe& operator=(Pipe const&) = delete;
+
+  ~Pipe()
+  {
+    for (auto& fd : wake_fd)
+    {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+}; // class Pipe
+
+// runs page and readme fetches in order on a background thread,
+// sending them all on one connection kept open between them
+class Worker
+{
+public:
+
+  explicit Worker(Options const& opts_) :
+    _opts {opts_},
+    _session {opts_.host},
+    _thread {[this] { loop(); }}
+  {
+  }
+
+  Worker(Worker const&) = delete;
+  Worker& operator=(Worker const&) = delete;
+
+  // ends the request in flight, then waits for the job to finish
+  ~Worker()
+  {
+    {
+      std::lock_guard<std::mutex> lock {_mutex};
+      _stop = true;
+    }
+
+    _session.stop();
+    _cv.notify_one();
+    _thread.join();
+  }
+
+  void push(Job job_)
+  {
+    {
+      std::lock_guard<std::mutex> lock {_mutex};
+      _jobs.emplace_back(std::move(job_));
+    }
+
+    _cv.notify_one();
+  }
+
+  // take the finished jobs
+  std::deque<Done> take()
+  {
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    return std::exchange(_done, {});
+  }
+
+private:
+
+  void loop()
+  {
+    for (;;)
+    {
+      Done res;
+
+      {
+        std::unique_lock<std::mutex> lock {_mutex};
+        _cv.wait(lock, [&] { return _stop || ! _jobs.empty(); });
+
+        if (_stop)
+        {
+          return;
+        }
+
+        res.job = std::move(_jobs.front());
+        _jobs.pop_front();
+      }
+
+      try
+      {
+        if (res.job.kind == Kind::readme)
+        {
+          res.readme = readme_fetch(_opts.host, res.job.repo, "", _opts.max_age, &_session);
+        }
+        else if (_opts.local)
+        {
+          auto found = Store::search(_opts.query, _opts.sort, _opts.order,
+            res.job.page, _opts.per_page);
+          res.res.total = found.total;
+          res.res.repos = std::move(found.repos);
+        }
+        else
+        {
+          res.res = search_fetch(_opts.host, _opts.query, _opts.sort, _opts.order,
+            res.job.page, _opts.per_page, _opts.token, _opts.max_age, _opts.api, _opts.prefetch,
+            &_session);
+        }
+      }
+      catch (std::exception const& e)
+      {
+        res.error = e.what();
+      }
+      catch (...)
+      {
+        res.error = "an unexpected error occurred";
+      }
+
+      {
+        std::lock_guard<std::mutex> lock {_mutex};
+        _done.emplace_back(std::move(res));
+      }
+
+      wake('j');
+    }
+  }
+
+  Options const& _opts;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::deque<Job> _jobs;
+  std::deque<Done> _done;
+  bool _stop {false};
+
+  // used on the worker thread, only stopped from the ui thread
+  Session _session;
+
+  // started last, after the members it uses
+  std::thread _thread;
+}; // class Worker
+
+// puts the terminal in raw mode on the alternate screen,
+// and forwards the signals that would end or resize the session to the self pipe
+class Terminal
+{
+public:
+
+  Terminal()
+  {
+    _mode.set_raw();
+
+    struct sigaction act {};
+    act.sa_handler = on_signal;
+    sigemptyset(&act.sa_mask);
+
+    for (std::size_t i = 0; i < _signals.size(); ++i)
+    {
+      sigaction(_signals.at(i), &act, &_old.at(i));
+    }
+
+    // alternate screen, hidden cursor, and no line wrapping
+    put("\x1b[?1049h\x1b[?25l\x1b[?7l");
+  }
+
+  Terminal(Terminal const&) = delete;
+  Terminal& operator=(Terminal const&) = delete;
+
+  ~Terminal()
+  {
+    put("\x1b[0m\x1b[?7h\x1b[?25h\x1b[?1049l");
+
+    for (std::size_t i = 0; i < _signals.size(); ++i)
+    {
+      sigaction(_signals.at(i), &_old.at(i), nullptr);
+    }
+  }
+
+private:
+
+  static void put(std::string_view str)
+  {
+    OB::Writer out {STDOUT_FILENO};
+    out.put(str);
+  }
+
+  std::array<int, 4> const _signals {{SIGINT, SIGTERM, SIGHUP, SIGWINCH}};
+  std::array<struct sigaction, 4> _old {};
+  OB::Term::Mode _mode;
+}; // class Terminal
+
+void on_signal(int sig)
+{
+  wake(sig == SIGWINCH ? 'w' : 'q');
+}
+
+// only uses async signal safe calls
+void wake(char c)
+{
+  auto const err = errno;
+  [[maybe_unused]] auto const n = ::write(wake_fd.at(1), &c, 1);
+  errno = err;
+}
+
+// get the first key in 'buf' and the number of bytes it used
+std::pair<Key, std::size_t> key_parse(std::string_view buf)
+{
+  if (buf.empty())
+  {
+    return {Key::none, 0};
+  }
+
+  if (buf.front() != '\x1b')
+  {
+    switch (buf.front())
+    {
+      case 'k': return {Key::up, 1};
+      case 'j': return {Key::down, 1};
+      case 'b': case '\x02': return {Key::page_up, 1};
+      case ' ': case 'f': case '\x06': return {Key::page_down, 1};
+      case 'g': return {Key::home, 1};
+      case 'G': return {Key::end, 1};
+      case '\n': case '\r': case 'l': return {Key::enter, 1};
+      case 'h': return {Key::back, 1};
+      case 'q': return {Key::quit, 1};
+      case 'r': return {Key::retry, 1};
+      default: return {Key::none, 1};
+    }
+  }
+
+  // a lone escape
+  if (buf.size() == 1 || (buf.at(1) != '[' && buf.at(1) != 'O'))
+  {
+    return {Key::back, 1};
+  }
+
+  // find the final byte of the sequence
+  std::size_t end {2};
+
+  while (end < buf.size() && (buf.at(end) < '\x40' || buf.at(end) > '\x7e'))
+  {
+    ++end;
+  }
+
+  if (end == buf.size())
+  {
+    return {Key::none, buf.size()};
+  }
+
+  auto const seq = buf.substr(2, end - 1);
+  Key key {Key::none};
+
+  if (seq == "A")
+  {
+    key = Key::up;
+  }
+  else if (seq == "B")
+  {
+    key = Key::down;
+  }
+  else if (seq == "C")
+  {
+    key = Key::enter;
+  }
+  else if (seq == "D")
+  {
+    key = Key::back;
+  }
+  else if (seq == "5~")
+  {
+    key = Key::page_up;
+  }
+  else if (seq == "6~")
+  {
+    key = Key::page_down;
+  }
+  else if (seq == "H" || seq == "1~")
+  {
+    key = Key::home;
+  }
+  else if (seq == "F" || seq == "4~")
+  {
+    key = Key::end;
+  }
+
+  return {key, end + 1};
+}
+
+std::string_view first_line(std::string_view str)
+{
+  return str.substr(0, str.find('\n'));
+}
+
+// the number of results that can be paged through
+std::size_t available(State const& st, Options const& opts)
+{
+  if (opts.local)
+  {
+    return st.total;
+  }
+
+  return std::min(st.total, api_max_results);
+}
+
+// split the selected readme into lines, rendering the markdown to 'width' with color
+void readme_lines(State& st, Options const& opts, std::size_t width)
+{
+  st.lines.clear();
+  st.line_styles.clear();
+  st.text.clear();
+  st.text_width = width;
+
+  auto const it = st.readmes.find(st.readme_repo);
+
+  if (it == st.readmes.end())
+  {
+    return;
+  }
+
+  if (opts.is_color)
+  {
+    std::ostringstream os;
+    Markdown::Renderer md {os, width};
+    md.feed(it->second);
+    md.finish();
+    st.text = os.str();
+  }
+  else
+  {
+    st.text = it->second;
+  }
+
+  std::string_view str {st.text};
+  Style style;
+
+  while (! str.empty())
+  {
+    auto const pos = std::min(str.find('\n'), str.size());
+    auto line = str.substr(0, pos);
+
+    if (! line.empty() && line.back() == '\r')
+    {
+      line.remove_suffix(1);
+    }
+
+    st.lines.emplace_back(line);
+    st.line_styles.emplace_back(style);
+    Screen::sgr(line, style);
+    str.remove_prefix(std::min(pos + 1, str.size()));
+  }
+}
+
+// fold a finished job into the state
+void apply(State& st, Done& done)
+{
+  if (done.job.kind == Kind::readme)
+  {
+    st.readme_pending.erase(done.job.repo);
+
+    if (! done.error.empty())
+    {
+      st.status = first_line(done.error);
+
+      return;
+    }
+
+    st.readmes[done.job.repo] = std::move(done.readme);
+
+    if (done.job.repo == st.readme_repo)
+    {
+      st.text_width = 0;
+    }
+
+    return;
+  }
+
+  st.pending = false;
+
+  if (! done.error.empty())
+  {
+    st.failed = true;
+    st.status = first_line(done.error);
+
+    return;
+  }
+
+  if (done.job.page != st.pages + 1)
+  {
+    return;
+  }
+
+  ++st.pages;
+  st.total = done.res.total;
+  st.status.clear();
+
+  if (done.res.rate)
+  {
+    st.rate = done.res.rate;
+  }
+
+  // an empty page means the results ended early
+  if (done.res.repos.empty())
+  {
+    st.total = st.repos.size();
+  }
+
+  st.repos.insert(st.repos.end(),
+    std::make_move_iterator(done.res.repos.begin()),
+    std::make_move_iterator(done.res.repos.end()));
+
+  // readmes sent with the page open without a request
+  for (auto& [repo, text] : done.res.readmes)
+  {
+    st.readmes.try_emplace(std::move(repo), std::move(text));
+  }
+}
+
+// keep the selection on screen
+void scroll(State& st, std::size_t rows)
+{
+  auto const visible = std::max<std::size_t>(rows / 2, 1);
+
+  if (st.repos.empty())
+  {
+    st.sel = 0;
+    st.top = 0;
+
+    return;
+  }
+
+  st.sel = std::min(st.sel, st.repos.size() - 1);
+
+  if (st.sel < st.top)
+  {
+    st.top = st.sel;
+  }
+  else if (st.sel >= st.top + visible)
+  {
+    st.top = st.sel - visible + 1;
+  }
+
+  if (! st.lines.empty())
+  {
+    auto const last = st.lines.size() > rows ? st.lines.size() - rows : 0;
+    st.line_top = std::min(st.line_top, last);
+  }
+  else
+  {
+    st.line_top = 0;
+  }
+}
+
+void on_key(State& st, Key key, std::size_t rows, bool& running, std::vector<Job>& jobs)
+{
+  auto const visible = std::max<std::size_t>(rows / 2, 1);
+
+  if (st.reading)
+  {
+    switch (key)
+    {
+      case Key::up: st.line_top -= std::min<std::size_t>(st.line_top, 1); break;
+      case Key::down: ++st.line_top; break;
+      case Key::page_up: st.line_top -= std::min(st.line_top, rows); break;
+      case Key::page_down: st.line_top += rows; break;
+      case Key::home: st.line_top = 0; break;
+      case Key::end: st.line_top = st.lines.size(); break;
+      case Key::back: case Key::quit: st.reading = false; break;
+      default: break;
+    }
+
+    return;
+  }
+
+  switch (key)
+  {
+    case Key::up: st.sel -= std::min<std::size_t>(st.sel, 1); break;
+    case Key::down: ++st.sel; break;
+    case Key::page_up:
+    {
+      st.sel -= std::min(st.sel, visible);
+      st.top -= std::min(st.top, visible);
+      break;
+    }
+    case Key::page_down:
+    {
+      st.sel += visible;
+      st.top += visible;
+      break;
+    }
+    case Key::home: st.sel = 0; break;
+    case Key::end: st.sel = st.repos.size(); break;
+    case Key::quit: running = false; break;
+    case Key::retry:
+    {
+      st.failed = false;
+      st.status.clear();
+      break;
+    }
+    case Key::enter:
+    {
+      if (st.sel >= st.repos.size())
+      {
+        break;
+      }
+
+      auto const& repo = st.repos.at(st.sel);
+      st.reading = true;
+      st.line_top = 0;
+      st.readme_repo = std::string(repo.owner).append("/").append(repo.name);
+      st.lines.clear();
+      st.text_width = 0;
+
+      if (st.readmes.find(st.readme_repo) == st.readmes.end() &&
+        st.readme_pending.insert(st.readme_repo).second)
+      {
+        jobs.emplace_back(Job {Kind::readme, 0, st.readme_repo});
+      }
+
+      break;
+    }
+    default: break;
+  }
+
+  // keep the page from scrolling past the end
+  if (st.repos.size() > visible)
+  {
+    st.top = std::min(st.top, st.repos.size() - visible);
+  }
+  else
+  {
+    st.top = 0;
+  }
+}
+
+void draw_list(Screen& scr, State const& st, Options const& opts, std::size_t rows)
+{
+  auto const visible = std::max<std::size_t>(rows / 2, 1);
+  auto const width = scr.width();
+
+  if (st.repos.empty() && ! st.failed)
+  {
+    scr.put(0, 0, st.pending ? "loading" : "no results");
+  }
+
+  for (std::size_t i = 0; i < visible && st.top + i < st.repos.size(); ++i)
+  {
+    auto const row = i * 2;
+    auto const pos = st.top + i;
+    auto const& e = st.repos.at(pos);
+
+    // the selection is drawn in reverse video across the whole width
+    auto const base = static_cast<std::uint8_t>(pos == st.sel ? Style::reverse : 0);
+
+    auto const style = [&](Color fg) {
+      if (! opts.is_color)
+      {
+        return Style {{}, {}, base};
+      }
+
+      return Style {fg, {}, static_cast<std::uint8_t>(base | Style::bold)};
+    };
+
+    std::pair<std::string, std::string> updated;
+    if (e.pushed_at)
+    {
+      updated = fuzzy_time(e.pushed_at);
+    }
+
+    scr.fill(0, row, width, Style {{}, {}, base});
+    scr.fill(0, row + 1, width, Style {{}, {}, base});
+
+    std::size_t x {0};
+    Style const plain {{}, {}, base};
+
+    x += scr.put(x, row, e.owner, style(Color::index(5)));
+    x += scr.put(x, row, "/", plain);
+    x += scr.put(x, row, e.name, style(Color::index(7)));
+    x += scr.put(x, row, " *", plain);
+    x += scr.put(x, row, std::to_string(e.stars), style(Color::index(2)));
+    x += scr.put(x, row, e.fork ? " >" : " <", plain);
+    x += scr.put(x, row, std::to_string(e.forks), style(Color::index(4)));
+    x += scr.put(x, row, " !", plain);
+    x += scr.put(x, row, std::to_string(e.issues), style(Color::index(6)));
+    x += scr.put(x, row, " [", plain);
+    x += scr.put(x, row, e.language, style(Color::hex(Lang::color(e.language_id))));
+    x += scr.put(x, row, "] ", plain);
+    scr.put(x, row, updated.first + updated.second, style(Color::index(3)));
+
+    scr.put(4, row + 1, e.description, plain);
+  }
+}
+
+void draw_readme(Screen& scr, State const& st, std::size_t rows)
+{
+  if (st.lines.empty() && st.readme_pending.count(st.readme_repo))
+  {
+    scr.put(0, 0, "loading");
+  }
+
+  for (std::size_t i = 0; i < rows && st.line_top + i < st.lines.size(); ++i)
+  {
+    scr.put_sgr(0, i, st.lines.at(st.line_top + i), st.line_styles.at(st.line_top + i));
+  }
+}
+
+// draw the next frame and write the cells that changed
+void draw(Screen& scr, State const& st, Options const& opts)
+{
+  auto const width = scr.width();
+  auto const rows = scr.height() - 1;
+
+  scr.clear();
+
+  if (st.reading)
+  {
+    draw_readme(scr, st, rows);
+  }
+  else
+  {
+    draw_list(scr, st, opts, rows);
+  }
+
+  // status line
+  std::string status {" "};
+
+  if (st.reading)
+  {
+    status += st.readme_repo;
+
+    if (! st.lines.empty())
+    {
+      status += " | lines " + std::to_string(st.line_top + 1) + "-" +
+        std::to_string(std::min(st.line_top + rows, st.lines.size())) + "/" +
+        std::to_string(st.lines.size());
+    }
+  }
+  else
+  {
+    auto const visible = std::max<std::size_t>(rows / 2, 1);
+    auto const pages = (available(st, opts) + opts.per_page - 1) / opts.per_page;
+
+    status +=
+      std::to_string(st.repos.empty() ? 0 : st.top + 1) + "-" +
+      std::to_string(std::min(st.top + visible, st.repos.size())) + "/" +
+      std::to_string(st.total) + " results | page " +
+      std::to_string(st.repos.empty() ? 0 : st.sel / opts.per_page + 1) + "/" +
+      std::to_string(pages);
+
+    if (st.rate)
+    {
+      status += " | " + std::to_string(st.rate->first) + "/" +
+        std::to_string(st.rate->second) + " limit";
+    }
+    else if (st.pages)
+    {
+      status += " | local";
+    }
+
+    if (st.pending)
+    {
+      status += " | loading";
+    }
+  }
+
+  if (st.reading && st.readme_pending.count(st.readme_repo))
+  {
+    status += " | loading";
+  }
+
+  if (! st.status.empty())
+  {
+    status += " | " + st.status;
+
+    if (st.failed && ! st.reading)
+    {
+      status += ", 'r' to retry";
+    }
+  }
+
+  std::string_view const help {st.reading ? "q back " : "enter readme  q quit "};
+  Style const bar {{}, {}, Style::reverse};
+
+  scr.fill(0, rows, width, bar);
+  auto const used = scr.put(0, rows, status, bar);
+
+  if (used + help.size() < width)
+  {
+    scr.put(width - help.size(), rows, help, bar);
+  }
+
+  scr.flush();
+}
+
+void run(Options const& opts)
+{
+  Pipe pipe;
+  Worker worker {opts};
+
+  // restored before the worker is joined, so the terminal comes back
+  // right away even if a request is still in flight
+  Terminal term;
+
+  Screen scr {STDOUT_FILENO};
+  State st;
+  bool running {true};
+  std::vector<Job> jobs;
+
+  while (running)
+  {
+    auto const [cols, lines] = OB::Term::size(STDOUT_FILENO);
+    auto const width = std::max<std::size_t>(cols, 1);
+    auto const height = std::max<std::size_t>(lines, 2);
+    auto const rows = height - 1;
+
+    if (st.reading && st.text_width != width)
+    {
+      readme_lines(st, opts, width);
+    }
+
+    scroll(st, rows);
+
+    // request the next page as soon as the last loaded one is on screen
+    auto const visible = std::max<std::size_t>(rows / 2, 1);
+    bool const more {st.pages == 0 || st.repos.size() < available(st, opts)};
+
+    if (more && ! st.pending && ! st.failed &&
+      st.top + visible + opts.per_page > st.repos.size())
+    {
+      st.pending = true;
+      worker.push(Job {Kind::page, st.pages + 1, {}});
+    }
+
+    scr.size(width, height);
+    draw(scr, st, opts);
+
+    std::array<pollfd, 2> fds {{
+      {STDIN_FILENO, POLLIN, 0},
+      {wake_fd.at(0), POLLIN, 0},
+    }};
+
+    if (::poll(fds.data(), fds.size(), -1) == -1)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      throw std::runtime_error("poll failed");
+    }
+
+    if (fds.at(1).revents & POLLIN)
+    {
+      std::array<char, 64> buf;
+      ssize_t n;
+
+      while ((n = ::read(wake_fd.at(0), buf.data(), buf.size())) > 0)
+      {
+        if (std::find(buf.begin(), buf.begin() + n, 'q') != buf.begin() + n)
+        {
+          running = false;
+        }
+      }
+
+      for (auto& e : worker.take())
+      {
+        apply(st, e);
+      }
+    }
+
+    if (fds.at(0).revents & POLLIN)
+    {
+      std::array<char, 64> buf;
+      auto const n = ::read(STDIN_FILENO, buf.data(), buf.size());
+
+      std::string_view str {buf.data(), n > 0 ? static_cast<std::size_t>(n) : 0};
+
+      while (! str.empty())
+      {
+        auto const [key, len] = key_parse(str);
+        on_key(st, key, rows, running, jobs);
+        str.remove_prefix(len);
+      }
+
+      for (auto& e : jobs)
+      {
+        worker.push(std::move(e));
+      }
+
+      jobs.clear();
+    }
+    else if (fds.at(0).revents & (POLLHUP | POLLERR))
+    {
+      running = false;
+    }
+  }
+}
+
+} // namespace OB::Stig::Tui
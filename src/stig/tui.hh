@@ -0,0 +1,45 @@
+#ifndef OB_STIG_TUI_HH
+#define OB_STIG_TUI_HH
+
+#include <cstddef>
+
+#include <string>
+
+namespace OB::Stig::Tui
+{
+
+struct Options
+{
+  std::string host;
+  std::string query;
+  std::string sort;
+  std::string order;
+  std::string token;
+
+  // results per page
+  std::size_t per_page {30};
+
+  // reuse cached responses up to this many seconds old
+  std::size_t max_age {0};
+
+  // the api to search with, 'v3' or 'graphql'
+  std::string api {"v3"};
+
+  // with graphql, the number of readmes fetched with each page
+  std::size_t prefetch {0};
+
+  // search the local store instead of the api
+  bool local {false};
+
+  bool is_color {true};
+}; // struct Options
+
+// browse the search results in the terminal until the user quits
+// pages and readmes are fetched on a background thread, and the page
+// after the one on screen is requested before it is scrolled into view
+// throws std::runtime_error if the terminal can not be set up
+void run(Options const& opts);
+
+} // namespace OB::Stig::Tui
+
+#endif // OB_STIG_TUI_HH